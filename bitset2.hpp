@@ -25,6 +25,7 @@
 #include "detail/array_complement2.hpp"
 #include "detail/array2array.hpp"
 #include "detail/bitset2_impl.hpp"
+#include "detail/storage_policy.hpp"
 
 #include <bitset>
 #include <climits>
@@ -43,22 +44,30 @@ namespace Bitset2
 
 
 
+/// \brief Storage is one of inline_storage (default), heap_storage,
+/// or arena_storage<Arena>, see detail/storage_policy.hpp.
 template<size_t N,
          class T= Bitset2::detail::select_base_t<N>,
+         class Storage= inline_storage,
          class Enabled=void> class bitset2;
 
-template<size_t N,class T>
-class bitset2<N,T,
-              typename std::enable_if<detail::is_unsgnd_int<T>::value>::type>
-: public detail::bitset2_impl<N,T>
+template<size_t N,class T,class S>
+class bitset2<N,T,S,
+              typename std::enable_if<detail::is_unsgnd_int<T>::value
+                                   && detail::is_storage_policy<S>::value>::type>
+: public detail::bitset2_impl<N,T,S>
 {
-  enum : size_t { base_t_n_bits= detail::bitset2_impl<N,T>::base_t_n_bits };
+  enum : size_t { base_t_n_bits= detail::bitset2_impl<N,T,S>::base_t_n_bits };
+  using detail::bitset2_impl<N,T,S>::is_inline;
+  using detail::bitset2_impl<N,T,S>::check_range;
 public:
-  using array_t=  typename detail::bitset2_impl<N,T>::array_t;
-  using ULLONG_t= typename detail::bitset2_impl<N,T>::ULLONG_t;
-  using LRGST_t=  typename detail::bitset2_impl<N,T>::LRGST_t;
+  using array_t=  typename detail::bitset2_impl<N,T,S>::array_t;
+  using ULLONG_t= typename detail::bitset2_impl<N,T,S>::ULLONG_t;
+  using LRGST_t=  typename detail::bitset2_impl<N,T,S>::LRGST_t;
   using base_t=   T;
-  using detail::bitset2_impl<N,T>::n_array;
+  using detail::bitset2_impl<N,T,S>::n_array;
+  /// Precomputed shift amount, see shift_left( shift_plan const & )
+  using shift_plan= detail::shift_plan<T>;
 
   enum : size_t { npos= detail::h_types<T>::npos };
 
@@ -68,12 +77,12 @@ public:
     reference() noexcept {}
 
     constexpr
-    reference( bitset2<N,T> *ptr, size_t bit ) noexcept
+    reference( bitset2 *ptr, size_t bit ) noexcept
     : m_ptr( ptr )
     , m_bit( bit )
     {}
 
-    bitset2<N,T> *m_ptr= nullptr;
+    bitset2      *m_ptr= nullptr;
     size_t       m_bit;
   public:
     constexpr
@@ -109,40 +118,48 @@ public:
 
   /* ------------------------------------------------------------- */
   constexpr
-  bitset2() noexcept
-  : detail::bitset2_impl<N,T>()
+  bitset2() noexcept( is_inline )
+  : detail::bitset2_impl<N,T,S>()
   {}
 
   constexpr
-  bitset2( bitset2 const & ) noexcept= default;
+  bitset2( bitset2 const & ) noexcept( is_inline )= default;
 
   constexpr
   bitset2( bitset2 && ) noexcept= default;
 
   constexpr
   bitset2 &
-  operator=( bitset2 const & ) noexcept= default;
+  operator=( bitset2 const & ) noexcept( is_inline )= default;
 
   constexpr
   bitset2 &
   operator=( bitset2 && ) noexcept= default;
 
+  /// \brief For internal use: Constructs the words from the result
+  /// of f(), an array_t, without copying it.
+  template<class F>
+  constexpr
+  bitset2( detail::gen_tag, F f ) noexcept( is_inline )
+  : detail::bitset2_impl<N,T,S>( detail::gen_tag{}, f )
+  {}
+
   explicit
-  bitset2( const std::bitset<N> &bs ) noexcept
-  : detail::bitset2_impl<N,T>( bs )
+  bitset2( const std::bitset<N> &bs ) noexcept( is_inline )
+  : detail::bitset2_impl<N,T,S>( bs )
   {}
 
   explicit
   constexpr
-  bitset2( LRGST_t v ) noexcept
-  : detail::bitset2_impl<N,T>( v )
+  bitset2( LRGST_t v ) noexcept( is_inline )
+  : detail::bitset2_impl<N,T,S>( v )
   {}
 
   template<size_t n,class Tsrc>
   explicit
   constexpr
-  bitset2( std::array<Tsrc,n> const & value ) noexcept
-  : detail::bitset2_impl<N,T>( value )
+  bitset2( std::array<Tsrc,n> const & value ) noexcept( is_inline )
+  : detail::bitset2_impl<N,T,S>( value )
   {}
 
   template< class CharT, class Traits, class Alloc >
@@ -155,7 +172,7 @@ public:
                     n = std::basic_string<CharT,Traits,Alloc>::npos,
            CharT    zero= CharT('0'),
            CharT    one=  CharT('1') )
-  : detail::bitset2_impl<N,T>( str, pos, n, zero, one )
+  : detail::bitset2_impl<N,T,S>( str, pos, n, zero, one )
   {}
 
 
@@ -166,7 +183,7 @@ public:
                               n=     std::basic_string<CharT>::npos,
            CharT              zero=  CharT('0'),
            CharT              one=   CharT('1') )
-  : detail::bitset2_impl<N,T>( n == std::basic_string<CharT>::npos
+  : detail::bitset2_impl<N,T,S>( n == std::basic_string<CharT>::npos
                                ? std::basic_string<CharT>( str )
                                : std::basic_string<CharT>( str, n ),
                                0, n, zero, one )
@@ -179,13 +196,23 @@ public:
   /// Bitwise NOT
   constexpr
   bitset2
-  operator~() const noexcept
-  { return bitset2(detail::array_ops<N,T>( 0 ).flip(this->data())); }
+  operator~() const & noexcept( is_inline )
+  {
+    bitset2 ret_val( *this );
+    ret_val.flip();
+    return ret_val;
+  }
+
+  /// Bitwise NOT, flips the bits of the temporary *this in place
+  constexpr
+  bitset2
+  operator~() && noexcept
+  { return std::move( flip() ); }
 
   constexpr
   bool
   operator[]( size_t bit ) const noexcept
-  { return detail::bitset2_impl<N,T>::operator[]( bit ); }
+  { return detail::bitset2_impl<N,T,S>::operator[]( bit ); }
 
   constexpr
   reference
@@ -204,11 +231,11 @@ public:
   friend
   constexpr
   bitset2
-  operator<<( bitset2 const & bs, size_t n_shift ) noexcept
+  operator<<( bitset2 const & bs, size_t n_shift ) noexcept( is_inline )
   {
-    return
-      Bitset2::bitset2<N,T>( Bitset2::detail::array_ops<N,T>( n_shift )
-                                                   .shift_left( bs.data() ) );
+    bitset2 ret_val( bs );
+    ret_val <<= n_shift;
+    return ret_val;
   }
 
   /// Stream output
@@ -237,11 +264,11 @@ public:
   friend
   constexpr
   bitset2
-  operator>>( bitset2 const & bs, size_t n_shift ) noexcept
+  operator>>( bitset2 const & bs, size_t n_shift ) noexcept( is_inline )
   {
-    return
-      Bitset2::bitset2<N,T>( Bitset2::detail::array_ops<N,T>( n_shift )
-                                                   .shift_right( bs.data() ) );
+    bitset2 ret_val( bs );
+    ret_val >>= n_shift;
+    return ret_val;
   }
 
   /// Stream input
@@ -252,32 +279,89 @@ public:
   {
     std::bitset<N>  bs;
     is >> bs;
-    x= Bitset2::bitset2<N,T>( bs );
+    x= Bitset2::bitset2<N,T,S>( bs );
     return is;
   }
 
+  /// Rotates in place, without a temporary array
   constexpr
   bitset2 &
   rotate_left( size_t n_rot ) noexcept
   {
-    this->get_data()= detail::array_ops<N,T>(n_rot).rotate_left( this->data() );
+    detail::array_ops<N,T>( n_rot ).rotate_assgn( this->get_data() );
     return *this;
   }
 
   constexpr
   bitset2 &
   rotate_right( size_t n_rot ) noexcept
+  { return rotate_left( N - ( n_rot % N ) ); }
+
+  /// \brief <<= K, the word offset, the bit shift and the masks are
+  /// constants, such that the word loop consists of funnel shifts only.
+  template<size_t K>
+  constexpr
+  bitset2 &
+  shift_left() noexcept
+  {
+    detail::array_ops<N,T>::template shift_left_assgn_k<K>( this->get_data() );
+    return *this;
+  }
+
+  /// >>= K, see shift_left<K>()
+  template<size_t K>
+  constexpr
+  bitset2 &
+  shift_right() noexcept
+  {
+    detail::array_ops<N,T>::template shift_right_assgn_k<K>( this->get_data() );
+    return *this;
+  }
+
+  /// \brief <<= by the amount p was constructed with. The plan is computed
+  /// once for loops which shift by the same runtime amount many times:
+  ///   bitset2<N>::shift_plan const p( n );
+  ///   for( ... ) bs.shift_left( p );
+  constexpr
+  bitset2 &
+  shift_left( shift_plan const &p ) noexcept
+  {
+    detail::array_ops<N,T>::shift_left_assgn( this->get_data(), p );
+    return *this;
+  }
+
+  /// >>= by the amount p was constructed with, see shift_left( p )
+  constexpr
+  bitset2 &
+  shift_right( shift_plan const &p ) noexcept
+  {
+    detail::array_ops<N,T>::shift_right_assgn( this->get_data(), p );
+    return *this;
+  }
+
+  /// Like rotate_left( K ) with offsets and shifts computed at compile time
+  template<size_t K>
+  constexpr
+  bitset2 &
+  rotate_left() noexcept
   {
-    this->get_data()= detail::array_ops<N,T>( N - ( n_rot % N ) )
-                                        .rotate_left( this->data() );
+    detail::array_ops<N,T>::template rotate_assgn_k<K>( this->get_data() );
     return *this;
   }
 
+  /// See rotate_left<K>()
+  template<size_t K>
+  constexpr
+  bitset2 &
+  rotate_right() noexcept
+  { return rotate_left<N - K % N>(); }
+
+  /// Reverses in place, without a temporary array
   constexpr
   bitset2 &
   reverse() noexcept
   {
-    this->get_data()= detail::array_ops<N,T>( 0 ).reverse( this->data() );
+    detail::array_ops<N,T>( 0 ).reverse_assgn( this->get_data() );
     return *this;
   }
 
@@ -301,11 +385,11 @@ public:
   friend
   constexpr
   bitset2
-  operator+( bitset2 const & bs1, bitset2 const & bs2 ) noexcept
+  operator+( bitset2 const & bs1, bitset2 const & bs2 ) noexcept( is_inline )
   {
-    return
-      Bitset2::bitset2<N,T>(
-        detail::array_add<N,T>().add( bs1.data(), bs2.data() ) );
+    bitset2 ret_val( bs1 );
+    ret_val += bs2;
+    return ret_val;
   }
 
   constexpr
@@ -318,7 +402,7 @@ public:
 
   constexpr
   bitset2
-  operator++(int) noexcept
+  operator++(int) noexcept( is_inline )
   {
     bitset2 tmp( *this );
     operator++();
@@ -335,7 +419,7 @@ public:
 
   constexpr
   bitset2
-  operator--(int) noexcept
+  operator--(int) noexcept( is_inline )
   {
     bitset2 tmp( *this );
     operator--();
@@ -354,14 +438,46 @@ public:
   friend
   constexpr
   bitset2
-  operator|( bitset2 const & bs1, bitset2 const & bs2 ) noexcept
+  operator|( bitset2 const & bs1, bitset2 const & bs2 ) noexcept( is_inline )
   {
-    return
-      Bitset2::bitset2<N,T>(
-        detail::array_funcs<bitset2::n_array,T>()
-                  .bitwise_or(bs1.data(), bs2.data()) );
+    if constexpr( is_inline )
+      return
+        Bitset2::bitset2<N,T,S>( detail::gen_tag{}, [&]{
+          return detail::array_funcs<bitset2::n_array,T>()
+                   .bitwise_or( bs1.data(), bs2.data() ); } );
+    else
+    {
+      bitset2 ret_val( bs1 );
+      ret_val |= bs2;
+      return ret_val;
+    }
   }
 
+  /// \brief Works in place on the temporary bs1, which becomes the
+  /// result. Inline words are written to the result directly instead,
+  /// which saves copying them.
+  friend
+  constexpr
+  bitset2
+  operator|( bitset2 && bs1, bitset2 const & bs2 ) noexcept
+  {
+    if constexpr( is_inline ) return std::as_const( bs1 ) | bs2;
+    else                      return std::move( bs1 |= bs2 );
+  }
+
+  /// See above
+  friend
+  constexpr
+  bitset2
+  operator|( bitset2 const & bs1, bitset2 && bs2 ) noexcept
+  { return std::move( bs2 ) | bs1; }
+
+  friend
+  constexpr
+  bitset2
+  operator|( bitset2 && bs1, bitset2 && bs2 ) noexcept
+  { return std::move( bs1 ) | std::as_const( bs2 ); }
+
   constexpr
   bitset2 &
   operator&=( bitset2 const & v2 ) noexcept
@@ -374,14 +490,46 @@ public:
   friend
   constexpr
   bitset2
-  operator&( bitset2 const & bs1, bitset2 const & bs2 ) noexcept
+  operator&( bitset2 const & bs1, bitset2 const & bs2 ) noexcept( is_inline )
   {
-    return
-      Bitset2::bitset2<N,T>(
-        detail::array_funcs<bitset2::n_array,T>()
-                  .bitwise_and( bs1.data(), bs2.data() ) );
+    if constexpr( is_inline )
+      return
+        Bitset2::bitset2<N,T,S>( detail::gen_tag{}, [&]{
+          return detail::array_funcs<bitset2::n_array,T>()
+                   .bitwise_and( bs1.data(), bs2.data() ); } );
+    else
+    {
+      bitset2 ret_val( bs1 );
+      ret_val &= bs2;
+      return ret_val;
+    }
+  }
+
+  /// \brief Works in place on the temporary bs1, which becomes the
+  /// result. Inline words are written to the result directly instead,
+  /// which saves copying them.
+  friend
+  constexpr
+  bitset2
+  operator&( bitset2 && bs1, bitset2 const & bs2 ) noexcept
+  {
+    if constexpr( is_inline ) return std::as_const( bs1 ) & bs2;
+    else                      return std::move( bs1 &= bs2 );
   }
 
+  /// See above
+  friend
+  constexpr
+  bitset2
+  operator&( bitset2 const & bs1, bitset2 && bs2 ) noexcept
+  { return std::move( bs2 ) & bs1; }
+
+  friend
+  constexpr
+  bitset2
+  operator&( bitset2 && bs1, bitset2 && bs2 ) noexcept
+  { return std::move( bs1 ) & std::as_const( bs2 ); }
+
   constexpr
   bitset2 &
   operator^=( bitset2 const & v2 ) noexcept
@@ -394,14 +542,46 @@ public:
   friend
   constexpr
   bitset2
-  operator^( bitset2 const & bs1, bitset2 const & bs2 ) noexcept
+  operator^( bitset2 const & bs1, bitset2 const & bs2 ) noexcept( is_inline )
   {
-    return
-      Bitset2::bitset2<N,T>(
-        detail::array_funcs<bitset2::n_array,T>()
-                  .bitwise_xor( bs1.data(), bs2.data() ) );
+    if constexpr( is_inline )
+      return
+        Bitset2::bitset2<N,T,S>( detail::gen_tag{}, [&]{
+          return detail::array_funcs<bitset2::n_array,T>()
+                   .bitwise_xor( bs1.data(), bs2.data() ); } );
+    else
+    {
+      bitset2 ret_val( bs1 );
+      ret_val ^= bs2;
+      return ret_val;
+    }
   }
 
+  /// \brief Works in place on the temporary bs1, which becomes the
+  /// result. Inline words are written to the result directly instead,
+  /// which saves copying them.
+  friend
+  constexpr
+  bitset2
+  operator^( bitset2 && bs1, bitset2 const & bs2 ) noexcept
+  {
+    if constexpr( is_inline ) return std::as_const( bs1 ) ^ bs2;
+    else                      return std::move( bs1 ^= bs2 );
+  }
+
+  /// See above
+  friend
+  constexpr
+  bitset2
+  operator^( bitset2 const & bs1, bitset2 && bs2 ) noexcept
+  { return std::move( bs2 ) ^ bs1; }
+
+  friend
+  constexpr
+  bitset2
+  operator^( bitset2 && bs1, bitset2 && bs2 ) noexcept
+  { return std::move( bs1 ) ^ std::as_const( bs2 ); }
+
   /// Computes the set difference, i.e. *this &= ~v2
   constexpr
   bitset2 &
@@ -412,20 +592,32 @@ public:
     return *this;
   }
 
+  /// \brief Sets each bit to f( this, bs2, bs3 ), where the boolean
+  /// function f is given by its truth table imm, see bitwise_ternary
+  template<uint8_t imm>
+  constexpr
+  bitset2 &
+  bitwise_ternary( bitset2 const & bs2, bitset2 const & bs3 ) noexcept
+  {
+    detail::array_ops<N,T>( 0 ).template ternary_op<imm>(
+                        this->data(), bs2.data(), bs3.data(), this->get_data() );
+    return *this;
+  }
+
   constexpr
   bitset2 &
   set() noexcept
-  { detail::bitset2_impl<N,T>::set(); return *this; }
+  { detail::bitset2_impl<N,T,S>::set(); return *this; }
 
   constexpr
   bitset2 &
   set( size_t bit, bool value= true )
-  { detail::bitset2_impl<N,T>::set( bit, value ); return *this; }
+  { detail::bitset2_impl<N,T,S>::set( bit, value ); return *this; }
 
   constexpr
   bitset2 &
   reset() noexcept
-  { detail::bitset2_impl<N,T>::reset(); return *this; }
+  { detail::bitset2_impl<N,T,S>::reset(); return *this; }
 
   constexpr
   bitset2 &
@@ -440,17 +632,95 @@ public:
  constexpr
  bool
  test_set( size_t bit, bool value= true )
- { return detail::bitset2_impl<N,T>::test_set( bit, value ); }
+ { return detail::bitset2_impl<N,T,S>::test_set( bit, value ); }
 
  constexpr
  bitset2 &
  flip() noexcept
- { detail::bitset2_impl<N,T>::flip(); return *this; }
+ { detail::bitset2_impl<N,T,S>::flip(); return *this; }
 
  constexpr
  bitset2 &
  flip( size_t bit )
- { detail::bitset2_impl<N,T>::flip( bit ); return *this; }
+ { detail::bitset2_impl<N,T,S>::flip( bit ); return *this; }
+
+ /// \brief Sets the bits in [lo, hi). Only the words overlapping the
+ /// range are touched. Throws out_of_range unless lo <= hi <= N.
+ constexpr
+ bitset2 &
+ set_range( size_t lo, size_t hi )
+ {
+   check_range( lo, hi, "bitset2: set_range out of range" );
+   detail::word_funcs<T>( N ).set_range( this->get_data().data(), lo, hi );
+   return *this;
+ }
+
+ /// Clears the bits in [lo, hi), see set_range
+ constexpr
+ bitset2 &
+ reset_range( size_t lo, size_t hi )
+ {
+   check_range( lo, hi, "bitset2: reset_range out of range" );
+   detail::word_funcs<T>( N ).reset_range( this->get_data().data(), lo, hi );
+   return *this;
+ }
+
+ /// Flips the bits in [lo, hi), see set_range
+ constexpr
+ bitset2 &
+ flip_range( size_t lo, size_t hi )
+ {
+   check_range( lo, hi, "bitset2: flip_range out of range" );
+   detail::word_funcs<T>( N ).flip_range( this->get_data().data(), lo, hi );
+   return *this;
+ }
+
+ /// \brief Returns the M bits [pos, pos + M) as a bitset2<M>. Only the
+ /// words overlapping the field are read. Throws out_of_range unless
+ /// pos + M <= N.
+ template<size_t M>
+ constexpr
+ bitset2<M,T,S>
+ extract( size_t pos ) const
+ {
+   check_range( pos, pos + M, "bitset2: extract out of range" );
+   return get_field<M>( pos );
+ }
+
+ /// Like extract( pos ) with pos checked at compile time
+ template<size_t M,size_t pos>
+ constexpr
+ bitset2<M,T,S>
+ extract() const noexcept( is_inline )
+ {
+   static_assert( pos + M <= N, "bitset2: extract out of range" );
+   return get_field<M>( pos );
+ }
+
+ /// \brief Overwrites the bits [pos, pos + M) with field, see extract.
+ /// Throws out_of_range unless pos + M <= N.
+ template<size_t M,class S2>
+ constexpr
+ bitset2 &
+ insert( size_t pos, bitset2<M,T,S2> const &field )
+ {
+   check_range( pos, pos + M, "bitset2: insert out of range" );
+   detail::array_ops<N,T>( pos ).template insert_field<M>( this->get_data(),
+                                                            field.data() );
+   return *this;
+ }
+
+ /// Like insert( pos, field ) with pos checked at compile time
+ template<size_t pos,size_t M,class S2>
+ constexpr
+ bitset2 &
+ insert( bitset2<M,T,S2> const &field ) noexcept
+ {
+   static_assert( pos + M <= N, "bitset2: insert out of range" );
+   detail::array_ops<N,T>( pos ).template insert_field<M>( this->get_data(),
+                                                            field.data() );
+   return *this;
+ }
 
  constexpr std::size_t size() const noexcept { return N; }
 
@@ -510,105 +780,332 @@ public:
    return ret_val;
  } // to_hex_string
 
+private:
+ /// Bits [pos, pos + M), pos + M <= N
+ template<size_t M>
+ constexpr
+ bitset2<M,T,S>
+ get_field( size_t pos ) const noexcept( is_inline )
+ {
+   return bitset2<M,T,S>( detail::gen_tag{}, [&]{
+            return detail::array_ops<N,T>( pos )
+                     .template extract_field<M>( this->data() ); } );
+ }
+
 }; // class bitset2
 
 
 
-template<size_t N, class T>
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+rotate_left( bitset2<N,T,S> const & bs, size_t n_rot )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+             return detail::array_ops<N,T>( n_rot ).rotate_left( bs.data() ); } );
+  else
+  {
+    bitset2<N,T,S> ret_val( bs );
+    ret_val.rotate_left( n_rot );
+    return ret_val;
+  }
+}
+
+
+/// \brief Rotates the temporary bs in place, which becomes the result.
+/// Inline words are rotated into the result directly instead, since
+/// the words of bs would be copied into the result afterwards.
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+rotate_left( bitset2<N,T,S> && bs, size_t n_rot ) noexcept
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return rotate_left( std::as_const( bs ), n_rot );
+  else
+    return std::move( bs.rotate_left( n_rot ) );
+}
+
+
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+rotate_right( bitset2<N,T,S> const & bs, size_t n_rot )
+  noexcept( detail::is_inline_storage<S>::value )
+{ return rotate_left( bs, N - ( n_rot % N ) ); }
+
+
+/// See rotate_left
+template<size_t N, class T, class S>
 constexpr
-bitset2<N,T>
-rotate_left( bitset2<N,T> const & bs, size_t n_rot ) noexcept
+bitset2<N,T,S>
+rotate_right( bitset2<N,T,S> && bs, size_t n_rot ) noexcept
+{ return rotate_left( std::move( bs ), N - ( n_rot % N ) ); }
+
+
+/// Computes the set difference, i.e. bs1 & ~bs2
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+difference( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2 )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+             return detail::array_funcs<bitset2<N,T,S>::n_array,T>()
+                      .bitwise_setdiff( bs1.data(), bs2.data() ); } );
+  else
+  {
+    bitset2<N,T,S> ret_val( bs1 );
+    ret_val.difference( bs2 );
+    return ret_val;
+  }
+}
+
+
+/// \brief Computes the set difference in place on the temporary bs1,
+/// see operator| of bitset2.
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+difference( bitset2<N,T,S> && bs1, bitset2<N,T,S> const & bs2 ) noexcept
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return difference( std::as_const( bs1 ), bs2 );
+  else
+    return std::move( bs1.difference( bs2 ) );
+}
+
+
+/// \brief Gathers the bits of src at the positions of the bits set in
+/// mask into the lowest bits of the result, like BMI2's pext on a
+/// single word. The remaining bits are zero.
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+extract_bits( bitset2<N,T,S> const & src, bitset2<N,T,S> const & mask )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+           return detail::array_ops<N,T>( 0 ).extract_bits( src.data(),
+                                                            mask.data() ); } );
+}
+
+
+/// \brief Scatters the lowest bits of src to the positions of the bits
+/// set in mask, like BMI2's pdep on a single word. The remaining bits
+/// are zero. Inverts extract_bits: deposit_bits( extract_bits( x, m ), m )
+/// equals x & m.
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+deposit_bits( bitset2<N,T,S> const & src, bitset2<N,T,S> const & mask )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+           return detail::array_ops<N,T>( 0 ).deposit_bits( src.data(),
+                                                            mask.data() ); } );
+}
+
+
+/// \brief Computes the boolean function of three inputs given by its
+/// truth table imm for each bit: Bit i of the result is bit
+/// ( bs1[i] << 2 | bs2[i] << 1 | bs3[i] ) of imm, as for AVX-512's
+/// vpternlog. For instance, 0xCA gives bs1 ? bs2 : bs3 (blend), 0xE8
+/// the majority, and 0xBA ( bs1 & ~bs2 ) | bs3. Each is computed in one
+/// pass without temporaries.
+template<uint8_t imm, size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+bitwise_ternary( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2,
+                 bitset2<N,T,S> const & bs3 )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+             return detail::array_ops<N,T>( 0 ).template ternary_op<imm>(
+                                      bs1.data(), bs2.data(), bs3.data() ); } );
+  else
+  {
+    bitset2<N,T,S> ret_val( bs1 );
+    ret_val.template bitwise_ternary<imm>( bs2, bs3 );
+    return ret_val;
+  }
+}
+
+
+/// \brief Works in place on the temporary bs1, see operator| of bitset2
+template<uint8_t imm, size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+bitwise_ternary( bitset2<N,T,S> && bs1, bitset2<N,T,S> const & bs2,
+                 bitset2<N,T,S> const & bs3 ) noexcept
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return bitwise_ternary<imm>( std::as_const( bs1 ), bs2, bs3 );
+  else
+    return std::move( bs1.template bitwise_ternary<imm>( bs2, bs3 ) );
+}
+
+
+/// Number of bits set in bs1 & bs2, without computing bs1 & bs2
+template<size_t N, class T, class S>
+constexpr
+size_t
+count_and( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2 ) noexcept
 {
   return
-    bitset2<N,T>( detail::array_ops<N,T>( n_rot ).rotate_left( bs.data() ) );
+    detail::array_funcs<bitset2<N,T,S>::n_array,T>()
+      .count_op( detail::bitwise_op_type::and_op, bs1.data(), bs2.data() );
 }
 
 
-template<size_t N, class T>
+/// Number of bits set in bs1 | bs2, without computing bs1 | bs2
+template<size_t N, class T, class S>
 constexpr
-bitset2<N,T>
-rotate_right( bitset2<N,T> const & bs, size_t n_rot ) noexcept
+size_t
+count_or( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2 ) noexcept
 {
   return
-    bitset2<N,T>( detail::array_ops<N,T>( N - ( n_rot % N ) ).
-                                               rotate_left( bs.data() ) );
+    detail::array_funcs<bitset2<N,T,S>::n_array,T>()
+      .count_op( detail::bitwise_op_type::or_op, bs1.data(), bs2.data() );
 }
 
 
-/// Computes the set difference, i.e. bs1 & ~bs2
-template<size_t N, class T>
+/// \brief Number of bits set in bs1 ^ bs2, i.e. the Hamming distance,
+/// without computing bs1 ^ bs2
+template<size_t N, class T, class S>
+constexpr
+size_t
+count_xor( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2 ) noexcept
+{
+  return
+    detail::array_funcs<bitset2<N,T,S>::n_array,T>()
+      .count_op( detail::bitwise_op_type::xor_op, bs1.data(), bs2.data() );
+}
+
+
+/// \brief Number of bits set in the set difference bs1 & ~bs2,
+/// without computing it
+template<size_t N, class T, class S>
 constexpr
-bitset2<N,T>
-difference( bitset2<N,T> const & bs1, bitset2<N,T> const & bs2 ) noexcept
+size_t
+count_difference( bitset2<N,T,S> const & bs1,
+                  bitset2<N,T,S> const & bs2 ) noexcept
 {
   return
-    bitset2<N,T>( detail::array_funcs<bitset2<N,T>::n_array,T>()
-                            .bitwise_setdiff( bs1.data(), bs2.data() ) );
+    detail::array_funcs<bitset2<N,T,S>::n_array,T>()
+      .count_op( detail::bitwise_op_type::sdiff_op, bs1.data(), bs2.data() );
 }
 
 
 /// Returns bs with bits reversed
-template<size_t N, class T>
+template<size_t N, class T, class S>
 constexpr
-bitset2<N,T>
-reverse( bitset2<N,T> const & bs ) noexcept
-{ return bitset2<N,T>( detail::array_ops<N,T>( 0 ).reverse( bs.data() ) ); }
+bitset2<N,T,S>
+reverse( bitset2<N,T,S> const & bs )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+             return detail::array_ops<N,T>( 0 ).reverse( bs.data() ); } );
+  else
+  {
+    bitset2<N,T,S> ret_val( bs );
+    ret_val.reverse();
+    return ret_val;
+  }
+}
+
+
+/// Reverses the temporary bs, see rotate_left
+template<size_t N, class T, class S>
+constexpr
+bitset2<N,T,S>
+reverse( bitset2<N,T,S> && bs ) noexcept
+{
+  if constexpr( detail::is_inline_storage<S>::value )
+    return reverse( std::as_const( bs ) );
+  else
+    return std::move( bs.reverse() );
+}
 
 
 /// Computes the two's complement
-template<size_t N, class T>
+template<size_t N, class T, class S>
 constexpr
-bitset2<N,T>
-complement2( bitset2<N,T> const & bs ) noexcept
-{ return bitset2<N,T>( detail::array_complement2<N,T>().comp2(bs.data()) ); }
+bitset2<N,T,S>
+complement2( bitset2<N,T,S> const & bs )
+  noexcept( detail::is_inline_storage<S>::value )
+{
+  bitset2<N,T,S> ret_val( bs );
+  ret_val.complement2();
+  return ret_val;
+}
 
 
 /// Half the sum of bs1 and bs2. No overflow occurs.
-template<size_t N, class T>
+template<size_t N, class T, class S>
 constexpr
-bitset2<N,T>
-midpoint( bitset2<N,T> const & bs1, bitset2<N,T> const & bs2,
-          bool round_down = false ) noexcept
+bitset2<N,T,S>
+midpoint( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2,
+          bool round_down = false )
+  noexcept( detail::is_inline_storage<S>::value )
 {
-  return bitset2<N,T>( detail::array_add<N,T>().midpoint(bs1.data(), bs2.data(),
-                                                         round_down) );
+  if constexpr( detail::is_inline_storage<S>::value )
+    return bitset2<N,T,S>( detail::gen_tag{}, [&]{
+             return detail::array_add<N,T>().midpoint( bs1.data(), bs2.data(),
+                                                       round_down ); } );
+  else
+  {
+    // Same as array_add::midpoint, the carry is added by increment
+    T const val0_1= bs1.data()[0];
+    T const val0_2= bs2.data()[0];
+    bool carry= val0_1 & val0_2 & 1;
+    if( !round_down && !carry ) carry= val0_1 & 1;
+    auto ret_val= bs1 >> 1;
+    ret_val += bs2 >> 1;
+    if( carry ) ++ret_val;
+    return ret_val;
+  }
 }
 
 
 
-/// Converts an M-bit bitset2 to an N-bit bitset2.
-template<size_t N,class T1,size_t M, class T2>
+/// \brief Converts an M-bit bitset2 to an N-bit bitset2 with the
+/// same storage policy.
+template<size_t N,class T1,size_t M, class T2, class S>
 constexpr
-bitset2<N,T1>
-convert_to( bitset2<M,T2> const & bs ) noexcept
-{
-  using a2a=
-    detail::array2array<bitset2<N,T1>::n_array,bitset2<M,T2>::n_array,T1,T2>;
-  return
-    bitset2<N,T1>(a2a()(detail::bit_chars<N,T1>::hgh_bit_pattern, bs.data()));
-}
+bitset2<N,T1,S>
+convert_to( bitset2<M,T2,S> const & bs )
+  noexcept( detail::is_inline_storage<S>::value )
+{ return bitset2<N,T1,S>( bs.data() ); }
 
 
-/// Converts an M-bit bitset2 to an N-bit bitset2.
-template<size_t N,size_t M, class T>
+/// \brief Converts an M-bit bitset2 to an N-bit bitset2 with the
+/// same storage policy.
+template<size_t N,size_t M, class T, class S>
 constexpr
-bitset2<N,T>
-convert_to( bitset2<M,T> const & bs ) noexcept
-{ return bitset2<N,T>( bs.data() ); }
+bitset2<N,T,S>
+convert_to( bitset2<M,T,S> const & bs )
+  noexcept( detail::is_inline_storage<S>::value )
+{ return bitset2<N,T,S>( bs.data() ); }
 
 
 /// \brief Returns true if f returns true for each pair
 /// of base_t=T values in bs1 and bs2. f should be a binary function
 /// taking two base_t values and returning bool.
 /// zip_fold_and does short circuit if possible.
-template<size_t N, class F, class T>
+template<size_t N, class F, class T, class S>
 constexpr
 bool
-zip_fold_and( bitset2<N,T> const & bs1, bitset2<N,T> const & bs2,
+zip_fold_and( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2,
               F f ) noexcept(noexcept( f( T(0), T(0) ) ))
 {
   return
-    detail::array_funcs<bitset2<N,T>::n_array,T>().zip_fold_and(bs1.data(),
+    detail::array_funcs<bitset2<N,T,S>::n_array,T>().zip_fold_and(bs1.data(),
                                                                 bs2.data(), f);
 }
 
@@ -617,37 +1114,59 @@ zip_fold_and( bitset2<N,T> const & bs1, bitset2<N,T> const & bs2,
 /// of base_t=T values in bs1 and bs2. f should be a binary function
 /// taking two base_t values and returning bool.
 /// zip_fold_or does short circuit if possible.
-template<size_t N, class F,class T>
+template<size_t N, class F,class T, class S>
 constexpr
 bool
-zip_fold_or( bitset2<N,T> const & bs1, bitset2<N,T> const & bs2,
+zip_fold_or( bitset2<N,T,S> const & bs1, bitset2<N,T,S> const & bs2,
              F f ) noexcept(noexcept( f( T(0), T(0) ) ))
 {
   return
-    detail::array_funcs<bitset2<N,T>::n_array,T>().zip_fold_or( bs1.data(),
+    detail::array_funcs<bitset2<N,T,S>::n_array,T>().zip_fold_or( bs1.data(),
                                                                 bs2.data(), f );
 }
 
 
 
+/// \brief 64 bit hash of bs. The result does not depend on T or on
+/// the platform, such that it can be persisted. It equals
+/// std::hash<bitset2<N,T>> for seed == 0, if size_t has 64 bits.
+template<size_t N, class T, class S>
+constexpr
+uint64_t
+stable_hash( bitset2<N,T,S> const & bs, uint64_t seed= 0 ) noexcept
+{ return detail::hash_impl<N,T>::hash64( bs.data(), seed ); }
+
+
+/// \brief Hash function object like std::hash<bitset2<N,T>>, but
+/// depending on a seed.
+struct seeded_hash
+{
+  uint64_t  seed= 0;
+
+  template<size_t N, class T, class S>
+  constexpr
+  size_t
+  operator()( bitset2<N,T,S> const & bs ) const noexcept
+  { return size_t( stable_hash( bs, seed ) ); }
+}; // struct seeded_hash
+
+
+
 } // namespace Bitset2
 
 
 namespace std
 {
-  template<size_t N,class T>
-  struct hash<Bitset2::bitset2<N,T> >
+  template<size_t N,class T,class S>
+  struct hash<Bitset2::bitset2<N,T,S> >
   {
   private:
-    enum : size_t
-    { n_array= Bitset2::detail::bitset2_impl<N,T>::n_array };
-
-    Bitset2::detail::hash_impl<n_array,T>   m_func;
+    Bitset2::detail::hash_impl<N,T>   m_func;
 
   public:
-    using argument_type= Bitset2::bitset2<N,T>;
+    using argument_type= Bitset2::bitset2<N,T,S>;
     using result_type=
-          typename Bitset2::detail::hash_impl<n_array,T>::result_type;
+          typename Bitset2::detail::hash_impl<N,T>::result_type;
 
     result_type operator()( argument_type const& bs ) const
     { return m_func( bs.data() ); }
@@ -0,0 +1,223 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_BOUNDED_BITSET2_CB_HPP
+#define BITSET2_BOUNDED_BITSET2_CB_HPP
+
+
+#include "bitset2.hpp"
+#include "detail/sized_bitset_impl.hpp"
+#include <array>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+
+
+
+namespace Bitset2
+{
+
+
+/// \brief Bitset with a size set at runtime, up to MaxN bits. The words
+/// are held in a std::array<T,...> inside the object, hence there are no
+/// heap allocations and everything apart from string conversions is
+/// constexpr. A single instantiation serves all sizes up to MaxN.
+/// The interface equals the one of dynamic_bitset2
+/// (see detail::sized_bitset_impl). Growing beyond MaxN throws
+/// std::length_error.
+template<size_t MaxN,class T= Bitset2::detail::select_base_t<MaxN> >
+class bounded_bitset2
+: public detail::sized_bitset_impl<bounded_bitset2<MaxN,T>,T>
+{
+  static_assert( detail::is_unsgnd_int<T>::value,
+                 "bounded_bitset2 requires an unsigned integral base type" );
+
+  using base=     detail::sized_bitset_impl<bounded_bitset2,T>;
+  using w_funcs=  detail::word_funcs<T>;
+
+  friend base;
+
+  using base::base_t_n_bits;
+
+  enum : size_t { n_array= detail::bit_chars<MaxN,T>::n_array };
+
+public:
+  using typename base::base_t;
+  using typename base::ULLONG_t;
+  using array_t=        std::array<T,n_array>;
+  using size_type=      size_t;
+
+
+  /* ------------------------------------------------------------- */
+  constexpr
+  bounded_bitset2() noexcept= default;
+
+  /// n_bits bits, the lowest ones initialized from value
+  explicit
+  constexpr
+  bounded_bitset2( size_t n_bits, ULLONG_t value= 0 )
+  : m_n_bits( check_n_bits( n_bits ) )
+  {
+    this->assign_ullong( value );
+    this->mask_hgh_bits();
+  }
+
+  /// Copies the bits of bs
+  template<size_t N>
+  explicit
+  constexpr
+  bounded_bitset2( bitset2<N,T> const &bs ) noexcept
+  : m_n_bits( N )
+  {
+    static_assert( N <= MaxN, "bounded_bitset2: bitset2 exceeds MaxN" );
+    for( size_t c= 0; c < w_funcs::n_words_for( N ); ++c )
+                                                   m_words[c]= bs.data()[c];
+  }
+
+  template< class CharT, class Traits, class SAlloc >
+  explicit
+  bounded_bitset2( std::basic_string<CharT,Traits,SAlloc> const
+                                                    & str,
+                   typename std::basic_string<CharT,Traits,SAlloc>::size_type
+                                                    pos = 0,
+                   typename std::basic_string<CharT,Traits,SAlloc>::size_type
+                                                    n = std::basic_string<CharT,Traits,SAlloc>::npos,
+                   CharT                            zero= CharT('0'),
+                   CharT                            one=  CharT('1') )
+  : m_n_bits( check_n_bits( base::string_n_bits( str, pos, n ) ) )
+  { this->assign_string( str, pos, zero, one ); }
+
+  template< class CharT >
+  explicit
+  bounded_bitset2( const CharT        *str,
+                   typename std::basic_string<CharT>::size_type
+                                      n=     std::basic_string<CharT>::npos,
+                   CharT              zero=  CharT('0'),
+                   CharT              one=   CharT('1') )
+  : bounded_bitset2( n == std::basic_string<CharT>::npos
+                     ? std::basic_string<CharT>( str )
+                     : std::basic_string<CharT>( str, n ),
+                     0, n, zero, one )
+  {}
+  /* ------------------------------------------------------------- */
+
+
+  //** Size and storage
+
+  constexpr size_t size()  const noexcept { return m_n_bits; }
+  constexpr bool   empty() const noexcept { return m_n_bits == 0; }
+
+  /// Maximal number of bits, i.e. MaxN
+  static
+  constexpr
+  size_t
+  max_size() noexcept
+  { return MaxN; }
+
+  /// \brief Changes size to n_bits. Added bits are set to value.
+  /// Throws length_error if n_bits > MaxN.
+  constexpr
+  void
+  resize( size_t n_bits, bool value= false )
+  {
+    check_n_bits( n_bits );
+    auto const old_n_bits= m_n_bits;
+    if( n_bits < old_n_bits )
+    {
+      for( size_t c= w_funcs::n_words_for( n_bits );
+           c < w_funcs::n_words_for( old_n_bits ); ++c ) m_words[c]= T(0);
+      m_n_bits= n_bits;
+      this->mask_hgh_bits();
+      return;
+    }
+    m_n_bits= n_bits;
+    if( !value || n_bits == old_n_bits ) return;
+    auto const lo_word= old_n_bits / base_t_n_bits;
+    m_words[lo_word] |= detail::ce_left_shift( w_funcs::all_one(),
+                                               old_n_bits % base_t_n_bits );
+    for( size_t c= lo_word + 1; c < n_words(); ++c )
+                                                m_words[c]= w_funcs::all_one();
+    this->mask_hgh_bits();
+  } // resize
+
+  /// \brief Appends a bit as new most significant bit.
+  /// Throws length_error if size() == MaxN.
+  constexpr
+  void
+  push_back( bool value )
+  {
+    // Not check_n_bits( m_n_bits + 1 ), which lets GCC assume that
+    // m_n_bits + 1 may wrap around, warning about array bounds
+    if( m_n_bits >= MaxN )
+                throw std::length_error( "bounded_bitset2: Size exceeds MaxN" );
+    this->set_noexcept( m_n_bits++, value );
+  }
+
+  /// Sets size to zero
+  constexpr
+  void
+  clear() noexcept
+  {
+    this->reset();
+    m_n_bits= 0;
+  }
+
+  /// Pointer to the words, the least significant one first
+  constexpr
+  base_t const *
+  data() const noexcept
+  { return m_words.data(); }
+
+  /// Number of words pointed to by data(), which are in use
+  constexpr
+  size_t
+  n_words() const noexcept
+  { return w_funcs::n_words_for( m_n_bits ); }
+
+  /// Converts to bitset2<N,T>. Throws invalid_argument if size() != N.
+  template<size_t N>
+  constexpr
+  bitset2<N,T>
+  to_bitset2() const
+  {
+    static_assert( N <= MaxN, "bounded_bitset2: bitset2 exceeds MaxN" );
+    if( m_n_bits != N )
+      throw std::invalid_argument( "bounded_bitset2: to_bitset2 size mismatch" );
+    typename bitset2<N,T>::array_t arr{};
+    for( size_t c= 0; c < arr.size(); ++c ) arr[c]= m_words[c];
+    return bitset2<N,T>( arr );
+  }
+
+private:
+  static
+  constexpr
+  size_t
+  check_n_bits( size_t n_bits )
+  {
+    return n_bits > MaxN
+      ? throw std::length_error( "bounded_bitset2: Size exceeds MaxN" )
+      : n_bits;
+  }
+
+  constexpr T       *word_ptr()       noexcept { return m_words.data(); }
+  constexpr T const *word_ptr() const noexcept { return m_words.data(); }
+
+  array_t    m_words{};
+  size_t     m_n_bits= 0;
+}; // class bounded_bitset2
+
+
+} // namespace Bitset2
+
+
+#endif // BITSET2_BOUNDED_BITSET2_CB_HPP
@@ -55,35 +55,14 @@ struct array2array
     static_assert( ( small_to_large && trgt_base_n_bits % src_base_n_bits == 0)
                 || (!small_to_large && src_base_n_bits % trgt_base_n_bits == 0),
                    "Conversion between arrays of these types not supported" );
-    return small_to_large
-      ? conv_small_to_large( pttrn, src, std::make_index_sequence<trgt_n-1>() )
-      : conv_large_to_small( pttrn, src, std::make_index_sequence<trgt_n-1>() );
-  }
-
-
-  template<size_t ... S1>
-  constexpr
-  trgt_array_t
-  conv_small_to_large( Ttrgt                      pttrn,
-                       src_array_t const          &src,
-                       std::index_sequence<S1...> ) const noexcept
-  {
-    return {{ get_from_smaller( S1, src, S1 * ts_div )...,
-              Ttrgt(   get_from_smaller( trgt_n-1, src, (trgt_n-1) * ts_div )
-                     & pttrn ) }};
-  }
-
-  template<size_t ... S1>
-  constexpr
-  trgt_array_t
-  conv_large_to_small( Ttrgt                      pttrn,
-                       src_array_t const          &src,
-                       std::index_sequence<S1...> ) const noexcept
-  {
-    return
-      {{ get_from_larger( S1 / ts_div, S1 % ts_div, src )...,
-         Ttrgt( get_from_larger((trgt_n-1) / ts_div, (trgt_n-1) % ts_div, src)
-                & pttrn ) }};
+    trgt_array_t ret_val{};
+    for( size_t c= 0; c < trgt_n; ++c )
+    {
+      ret_val[c]= small_to_large ? get_from_smaller( c, src, c * ts_div )
+                                 : get_from_larger( c / ts_div, c % ts_div, src );
+    }
+    ret_val[trgt_n-1] &= pttrn;
+    return ret_val;
   }
 
   constexpr
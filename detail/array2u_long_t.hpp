@@ -85,9 +85,11 @@ namespace detail
     bool
     check_impl( array_t const & arr, size_t idx ) const noexcept
     {
-      return idx >= n_array ? false
-             : ( ( take_check( arr, idx ) != base_t(0) )
-                 || check_impl( arr, idx + 1 ) );
+      for( ; idx < n_array; ++idx )
+      {
+        if( take_check( arr, idx ) != base_t(0) ) return true;
+      }
+      return false;
     }
 
     constexpr
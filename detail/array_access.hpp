@@ -14,6 +14,7 @@
 #define BITSET2_ARRAY_ACCESS_CB_HPP
 
 #include "bit_chars.hpp"
+#include "word_funcs.hpp"
 
 
 namespace Bitset2
@@ -39,37 +40,7 @@ namespace detail
     constexpr
     base_t
     get_four_bits( array_t const &arr, size_t offset ) const noexcept
-    {
-      return
-        get_four_bits_impl( arr,
-                            offset / base_t_n_bits, offset % base_t_n_bits );
-    }
-
-    constexpr
-    base_t
-    get_four_bits_impl( array_t const &arr,
-                        size_t idx, size_t bit_idx ) const noexcept
-    {
-      return ( bit_idx >= 3 )
-             ? h1_get_four_bits( arr[idx], bit_idx )
-             : h2_get_four_bits( arr, idx, bit_idx );
-    }
-
-    constexpr
-    base_t
-    h1_get_four_bits( base_t v, size_t bit_idx ) const noexcept
-    { return ( v >> ( bit_idx - 3 ) ) & base_t(0xF); }
-
-    constexpr
-    base_t
-    h2_get_four_bits( array_t const &arr,
-                      size_t idx, size_t bit_idx ) const noexcept
-    {
-      return
-        (( arr[idx] & ( ( base_t(1) << (bit_idx+1) ) - 1 ) ) << ( 3 - bit_idx ))
-        + ( ( idx == 0 ) ? base_t(0)
-                         : ( arr[idx-1] >> (base_t_n_bits - (3 - bit_idx)) ) );
-    }
+    { return word_funcs<T>::get_four_bits( arr.data(), offset ); }
   }; // struct array_access
 
 
@@ -50,15 +50,12 @@ namespace detail
     add_assgn( array_t &arr1, array_t const &arr2,
                base_t  carry= base_t(0) ) const noexcept
     {
-      for( size_t  c= 0; c < n_array; ++c )
-      {
-        auto const sm1= base_t( arr2[c] + carry );
-        auto const sm=  base_t( arr1[c] + sm1 );
-        carry=  sm < arr1[c] || sm1 < arr2[c];
-        arr1[c]= sm;
-      }
-      arr1[n_array-1] &= hgh_bit_pattern;
-    } // add_assgn
+      if( use_shared_kernels<n_array,T>() )
+        shared_kernels<T>::add_assgn( arr1.data(), n_array, hgh_bit_pattern,
+                                      arr2.data(), carry );
+      else
+        word_funcs<T>( N ).add_assgn( arr1.data(), arr2.data(), carry );
+    }
 
     constexpr
     array_t
@@ -46,15 +46,11 @@ namespace detail
     void
     comp2_assgn( array_t &arr ) const noexcept
     {
-      base_t  carry= base_t(1);
-      for( size_t  c= 0; c < n_array; ++c )
-      {
-        auto const sm= base_t( base_t(~arr[c]) + carry );
-        carry=  base_t( (carry == base_t(1)) && ( sm == 0 ) );
-        arr[c]= sm;
-      } // for c
-      arr[n_array-1] &= hgh_bit_pattern;
-    } // comp2_assgn
+      if( use_shared_kernels<n_array,T>() )
+        shared_kernels<T>::comp2_assgn( arr.data(), n_array, hgh_bit_pattern );
+      else
+        word_funcs<T>( N ).comp2_assgn( arr.data() );
+    }
 
   }; // struct array_complement2
 
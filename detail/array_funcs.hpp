@@ -15,60 +15,62 @@
 
 
 #include "h_types.hpp"
-#include "count_bits.hpp"
-#include "index_lsb_set.hpp"
-#include "index_msb_set.hpp"
+#include "word_funcs.hpp"
+#include "shared_kernels.hpp"
 #include <utility>
 
-#if __cplusplus >= 202002L
-# include <bit>
-# ifdef __cpp_lib_int_pow2
-#  define CMPLRPOW2
-# endif
-#endif
 
 namespace Bitset2
 {
 namespace detail
 {
-#ifdef CMPLRPOW2
-  template<class T>
-  constexpr
-  bool loc_test_single_bit( T val )
-  { return std::has_single_bit( val ); }
-  
-# ifdef __SIZEOF_INT128__
-  template<>
-  constexpr
-  bool loc_test_single_bit( unsigned __int128 val )
-  { return (val & (val - 1)) == 0; }
-# endif
-#else
-  template<class T>
-  constexpr
-  bool loc_test_single_bit( T val )
-  { return (val & T(val - T(1))) == T(0); }
-#endif
-
   template<size_t n_array,class T>
   struct array_funcs
   {
       using base_t=                 T;
       using array_t=       typename h_types<T>::template array_t<n_array>;
       using array_p1_t=    typename h_types<T>::template array_t<n_array+1>;
+      using w_funcs=                word_funcs<T>;
+      using s_kernels=              shared_kernels<T>;
 
       enum : size_t { base_t_n_bits=  h_types<T>::base_t_n_bits
                     , npos=           h_types<T>::npos };
 
       /// Binary operator type
-      enum class op_type { or_op, and_op, xor_op, sdiff_op };
+      using op_type= bitwise_op_type;
+
+      enum : bool
+      { use_simd= n_array * sizeof(base_t) >= rt_kernel_min_bytes };
+
+      /// All n_array words are in use
+      enum : base_t { tail_mask= base_t(~base_t(0)) };
+
+      /// The word level algorithms, operating on all n_array words
+      static
+      constexpr
+      w_funcs
+      wf() noexcept
+      { return w_funcs( n_array * base_t_n_bits ); }
+
+      /// True if the runtime path should call shared_kernels<T>
+      static
+      constexpr
+      bool
+      shared() noexcept
+      { return use_shared_kernels<n_array,T>(); }
+
+      /// Same for the streaming operations
+      static
+      constexpr
+      bool
+      shared_stream() noexcept
+      { return use_shared_kernels<n_array,T,rt_shared_stream_min_bytes>(); }
 
       constexpr
       array_t
       bitwise_or( array_t const &arr1, array_t const &arr2 ) const noexcept
       {
-          return bitwise_op_impl( op_type::or_op, arr1, arr2,
-                                  std::make_index_sequence<n_array>() );
+          return bitwise_op_impl( op_type::or_op, arr1, arr2 );
       }
 
       /// Used for |= operator. Separate implementation for better performance.
@@ -81,8 +83,7 @@ namespace detail
       array_t
       bitwise_and( array_t const &arr1, array_t const &arr2 ) const noexcept
       {
-        return bitwise_op_impl( op_type::and_op, arr1, arr2,
-                                std::make_index_sequence<n_array>() );
+        return bitwise_op_impl( op_type::and_op, arr1, arr2 );
       }
 
       /// Used for &= operator. Separate implementation for better performance.
@@ -95,8 +96,7 @@ namespace detail
       array_t
       bitwise_xor( array_t const &arr1, array_t const &arr2 ) const noexcept
       {
-        return bitwise_op_impl( op_type::xor_op, arr1, arr2,
-                                std::make_index_sequence<n_array>() );
+        return bitwise_op_impl( op_type::xor_op, arr1, arr2 );
       }
 
       /// Used for ^= operator. Separate implementation for better performance.
@@ -110,8 +110,7 @@ namespace detail
       array_t
       bitwise_setdiff( array_t const &arr1, array_t const &arr2 ) const noexcept
       {
-        return bitwise_op_impl( op_type::sdiff_op, arr1, arr2,
-                                std::make_index_sequence<n_array>() );
+        return bitwise_op_impl( op_type::sdiff_op, arr1, arr2 );
       }
 
       /// \brief Computes the set difference, i.e. arr1 & ~arr2.
@@ -125,271 +124,260 @@ namespace detail
       constexpr
       bool
       none( array_t const &arr ) const noexcept
-      { return none_impl( n_array - 1, arr ); }
+      {
+        return   shared_stream() ? s_kernels::none( arr.data(), n_array, tail_mask )
+               : wf().none( arr.data() );
+      }
 
 
       constexpr
       size_t
       count( array_t const &arr ) const noexcept
       {
-        size_t ct = 0;
-        for( size_t i= 0; i < n_array; ++i ) ct += count_bits(arr[i]);
-        return ct;
+        return   shared_stream() ? s_kernels::count( arr.data(), n_array, tail_mask )
+               : wf().count( arr.data() );
       }
-      
-      
-      constexpr
-      bool
-      has_single_bit( array_t const &arr ) const noexcept
-      {
-          size_t ct = 0;
-          for( size_t i= 0; i < n_array; ++i )
-          {
-              base_t x = arr[i];
-              if( x == T(0) ) continue;
-              if( loc_test_single_bit(x) ) ++ct;
-              else return false;
-              if( ct > 1 ) return false;
-          }
-          return ct == 1;
-      } // has_single_bit
 
 
+      /// Counts word by word, used during constant evaluation
       constexpr
-      bool
-      equal( array_t const &arr1, array_t const &arr2 ) const noexcept
-      { return equal_impl( arr1, arr2, 0 ); }
-
-
-      constexpr
-      bool
-      less_than( array_t const &arr1, array_t const &arr2 ) const noexcept
-      { return less_than_impl( arr1, arr2, n_array - 1 ); }
+      size_t
+      count_impl( array_t const &arr ) const noexcept
+      { return wf().count_impl( arr.data() ); }
 
 
-      /// \brief Returns true if f returns true for each pair
-      /// of elements in arr1 and arr2
-      template<class F>
+      /// \brief Number of bits set in arr1 opt arr2. The result of
+      /// the operation is not stored.
       constexpr
-      bool
-      zip_fold_and( array_t const &arr1, array_t const &arr2,
-                    F &f ) const noexcept(noexcept( f( base_t(0), base_t(0) ) ))
-      { return zip_fold_and_impl( arr1, arr2, f, 0 ); }
+      size_t
+      count_op( op_type opt,
+                array_t const &arr1, array_t const &arr2 ) const noexcept
+      {
+        return   shared_stream()
+               ? s_kernels::count_op( arr1.data(), n_array, tail_mask,
+                                      opt, arr2.data() )
+               : wf().count_op( opt, arr1.data(), arr2.data() );
+      }
 
 
-      /// \brief Returns true if f returns true for at least one pair
-      /// of elements in arr1 and arr2
-      template<class F>
+      /// Number of bits set below position idx, idx <= N
       constexpr
-      bool
-      zip_fold_or( array_t const &arr1, array_t const &arr2,
-                   F &f ) const noexcept(noexcept( f( base_t(0), base_t(0) ) ))
-      { return zip_fold_or_impl( arr1, arr2, f, 0 ); }
+      size_t
+      rank( array_t const &arr, size_t idx ) const noexcept
+      {
+        return   shared() ? s_kernels::rank( arr.data(), n_array, tail_mask, idx )
+               : wf().rank( arr.data(), idx );
+      }
 
 
-      /// Prepend v1 in front of arr
+      /// \brief Index of k-th (counting from zero) bit set.
+      /// Returns npos if less than k+1 bits are set.
       constexpr
-      array_p1_t
-      prepend( base_t const v1, array_t const &arr ) const noexcept
-      { return prepend_impl( v1, arr, std::make_index_sequence<n_array>()); }
+      size_t
+      select( array_t const &arr, size_t k ) const noexcept
+      {
+        return   shared() ? s_kernels::select( arr.data(), n_array, tail_mask, k )
+               : wf().select( arr.data(), k );
+      }
 
 
-      /// Append v1 to arr
+      /// \brief Writes the indices of the set bits in ascending order
+      /// to out, at most max_n of them. Returns the number written.
+      template<class IdxT>
       constexpr
-      array_p1_t
-      append( array_t const &arr, base_t const v1 ) const noexcept
-      { return append_impl( arr, v1, std::make_index_sequence<n_array>()); }
+      size_t
+      decode_positions( array_t const &arr,
+                        IdxT *out, size_t max_n ) const noexcept
+      {
+        return   shared()
+               ? s_kernels::decode_positions( arr.data(), n_array, tail_mask,
+                                              out, max_n )
+               : wf().decode_positions( arr.data(), out, max_n );
+      }
 
 
-      /// Copy each element in arr but apply pttrn to most significant entry
-      template<size_t n>
+      /// Decodes word by word, used during constant evaluation
+      template<class IdxT>
       constexpr
-      array_t
-      copy_and_map( base_t const                          pttrn,
-                    typename
-                    h_types<T>::template array_t<n> const &arr ) const noexcept
-      {
-        return
-          n_array == 0 ? array_t{}
-             : copy_and_map_impl(
-                 pttrn,
-                 arr,
-                 gen_empty_array<n_array,T>(),
-                 n >= n_array,
-                 std::make_index_sequence<ce_min( n_array-1, n )>(),
-                 std::make_index_sequence<n_array-1-ce_min(n_array-1, n)>() );
-      } // copy_and_map
-
+      size_t
+      decode_positions_impl( array_t const &arr,
+                             IdxT *out, size_t max_n ) const noexcept
+      { return wf().decode_positions_impl( arr.data(), out, max_n ); }
 
-      //** _impl functions
 
-      template<size_t n,size_t ... S1,size_t ... S2>
       constexpr
-      array_t
-      copy_and_map_impl( base_t const                          pttrn,
-                         typename
-                         h_types<T>::template array_t<n> const &arr,
-                         array_t const                         &zeroes,
-                         bool const                            take_all,
-                         std::index_sequence<S1...>,
-                         std::index_sequence<S2...> ) const noexcept
+      bool
+      has_single_bit( array_t const &arr ) const noexcept
       {
-        return {{ arr[S1]..., zeroes[S2]...,
-                  base_t(( take_all ? arr[n_array-1] : base_t(0) ) & pttrn) }};
+        return   shared()
+               ? s_kernels::has_single_bit( arr.data(), n_array, tail_mask )
+               : wf().has_single_bit( arr.data() );
       }
 
 
-
       constexpr
       bool
-      none_impl( size_t idx, array_t const &arr ) const noexcept
+      equal( array_t const &arr1, array_t const &arr2 ) const noexcept
       {
-        return    ( arr[idx] == base_t(0) )
-               && ( ( idx == 0 ) ? true : none_impl( idx - 1, arr )  );
+        return   shared_stream()
+               ? s_kernels::equal( arr1.data(), n_array, tail_mask, arr2.data() )
+               : wf().equal( arr1.data(), arr2.data() );
       }
 
 
-      template<size_t ... S>
       constexpr
-      array_p1_t
-      append_impl( array_t const &arr, base_t const v1,
-                   std::index_sequence<S...> ) const noexcept
-      { return {{ arr[S]..., v1 }}; }
+      bool
+      less_than( array_t const &arr1, array_t const &arr2 ) const noexcept
+      { return compare( arr1, arr2 ) < 0; }
 
 
-      template<size_t ... S>
+      /// \brief Three-way comparison in a single pass.
+      /// Returns -1, 0, or 1 if arr1 is less, equal, or greater than arr2.
       constexpr
-      array_p1_t
-      prepend_impl( base_t const v1, array_t const &arr,
-                    std::index_sequence<S...> ) const noexcept
-      { return {{ v1, arr[S]... }}; }
+      int
+      compare( array_t const &arr1, array_t const &arr2 ) const noexcept
+      {
+        return   shared()
+               ? s_kernels::compare( arr1.data(), n_array, tail_mask, arr2.data() )
+               : wf().compare( arr1.data(), arr2.data() );
+      }
 
 
+      /// \brief Returns true if f returns true for each pair
+      /// of elements in arr1 and arr2
+      template<class F>
       constexpr
       bool
-      equal_impl( array_t const &arr1, array_t const &arr2,
-                  size_t ct ) const noexcept
+      zip_fold_and( array_t const &arr1, array_t const &arr2,
+                    F &f ) const noexcept(noexcept( f( base_t(0), base_t(0) ) ))
       {
-        return   ( ct == n_array ) ? true
-               : ( arr1[ct] == arr2[ct] ) && equal_impl( arr1, arr2, ct + 1 );
+        for( size_t c= 0; c < n_array; ++c )
+        {
+          if( !f( arr1[c], arr2[c] ) ) return false;
+        }
+        return true;
       }
 
 
+      /// \brief Returns true if f returns true for at least one pair
+      /// of elements in arr1 and arr2
+      template<class F>
       constexpr
       bool
-      less_than_impl( array_t const &arr1, array_t const &arr2,
-                      size_t ct ) const noexcept
+      zip_fold_or( array_t const &arr1, array_t const &arr2,
+                   F &f ) const noexcept(noexcept( f( base_t(0), base_t(0) ) ))
       {
-        return
-          ( arr1[ct] < arr2[ct] )
-          || ( arr1[ct] == arr2[ct]
-               && ( ct == 0 ? false : less_than_impl( arr1, arr2, ct-1 ) ) );
+        for( size_t c= 0; c < n_array; ++c )
+        {
+          if( f( arr1[c], arr2[c] ) ) return true;
+        }
+        return false;
       }
 
 
-      template<class F>
+      /// Prepend v1 in front of arr
       constexpr
-      bool
-      zip_fold_and_impl( array_t const &arr1, array_t const &arr2,
-                         F      &f,
-                         size_t ct )
-                            const noexcept(noexcept( f(base_t(0), base_t(0))))
+      array_p1_t
+      prepend( base_t const v1, array_t const &arr ) const noexcept
       {
-        return   ( ct == n_array ) ? true
-               : (    f( arr1[ct], arr2[ct] )
-                   && zip_fold_and_impl( arr1, arr2, f, ct + 1 ) );
+        array_p1_t ret_val{};
+        ret_val[0]= v1;
+        for( size_t c= 0; c < n_array; ++c ) ret_val[c+1]= arr[c];
+        return ret_val;
       }
 
 
-      template<class F>
+      /// Append v1 to arr
       constexpr
-      bool
-      zip_fold_or_impl( array_t const &arr1, array_t const &arr2,
-                        F      &f,
-                        size_t ct )
-                            const noexcept(noexcept( f(base_t(0), base_t(0))))
+      array_p1_t
+      append( array_t const &arr, base_t const v1 ) const noexcept
       {
-        return   ( ct == n_array ) ? false
-               : (    f( arr1[ct], arr2[ct] )
-                   || zip_fold_or_impl( arr1, arr2, f, ct + 1 ) );
+        array_p1_t ret_val{};
+        for( size_t c= 0; c < n_array; ++c ) ret_val[c]= arr[c];
+        ret_val[n_array]= v1;
+        return ret_val;
       }
 
 
+      /// Copy each element in arr but apply pttrn to most significant entry
+      template<size_t n>
+      constexpr
+      array_t
+      copy_and_map( base_t const                          pttrn,
+                    typename
+                    h_types<T>::template array_t<n> const &arr ) const noexcept
+      {
+        array_t ret_val{};
+        if( n_array == 0 ) return ret_val;
+        for( size_t c= 0; c < ce_min( n_array - 1, n ); ++c ) ret_val[c]= arr[c];
+        if( n >= n_array ) ret_val[n_array-1]= base_t( arr[n_array-1] & pttrn );
+        return ret_val;
+      } // copy_and_map
+
+
+      //** _impl functions
+
       constexpr
       void
       bitwise_op_assgn_impl( op_type opt,
                              array_t &arr1, array_t const &arr2 ) const noexcept
       {
-        for( size_t c= 0; c < n_array; ++c )
-        {
-          if(      opt == op_type::or_op  ) arr1[c] |=  arr2[c];
-          else if( opt == op_type::and_op ) arr1[c] &=  arr2[c];
-          else if( opt == op_type::xor_op ) arr1[c] ^=  arr2[c];
-          else                              arr1[c] &= ~arr2[c];
-        }
-      } // bitwise_op_assgn_impl
+        if( shared_stream() )
+          s_kernels::bitwise_op( arr1.data(), n_array, tail_mask,
+                                 opt, arr1.data(), arr2.data() );
+        else
+          wf().bitwise_op( opt, arr1.data(), arr1.data(), arr2.data() );
+      }
 
 
-      template<size_t ... S>
       constexpr
       array_t
       bitwise_op_impl( op_type opt,
-                       array_t const &arr1, array_t const &arr2,
-                       std::index_sequence<S...> ) const noexcept
-      { return {{ h_bitwise_op( S, opt, arr1, arr2 )... }};  }
+                       array_t const &arr1, array_t const &arr2 ) const noexcept
+      {
+        if( ( use_simd && use_rt_kernels() ) || shared_stream() )
+                                return rt_bitwise_op( opt, arr1, arr2 );
+        array_t ret_val{};
+        wf().bitwise_op( opt, ret_val.data(), arr1.data(), arr2.data() );
+        return ret_val;
+      }
 
-      constexpr
-      base_t
-      h_bitwise_op( size_t idx, op_type opt,
-                    array_t const &arr1, array_t const &arr2 ) const noexcept
+      /// Not constexpr, such that ret_val needs no initialization
+      array_t
+      rt_bitwise_op( op_type opt,
+                     array_t const &arr1, array_t const &arr2 ) const noexcept
       {
-            switch( opt )
-            {
-                case op_type::or_op:  return arr1[idx] | arr2[idx];
-                case op_type::and_op: return arr1[idx] & arr2[idx];
-                case op_type::xor_op: return arr1[idx] ^ arr2[idx];
-                default: return arr1[idx] & base_t(~arr2[idx]);      // set difference
-            } // switch
-      } // h_bitwise_op
+        array_t ret_val;
+        if( shared_stream() )
+          s_kernels::bitwise_op( ret_val.data(), n_array, tail_mask,
+                                 opt, arr1.data(), arr2.data() );
+        else
+          rt_kernels::bitwise_op( opt, ret_val.data(), arr1.data(), arr2.data(),
+                                  sizeof(array_t) );
+        return ret_val;
+      }
 
 
       constexpr
       size_t
       idx_lsb_set( array_t const &arr, base_t v, size_t idx, base_t hgh_bit_pttrn ) const noexcept
       {
-        bool const complement = hgh_bit_pttrn != base_t(2);
-        if( complement && idx + 1 == n_array )  v &= hgh_bit_pttrn;
-        while( idx < n_array )
-        {
-          if( v != 0 ) return idx * base_t_n_bits + index_lsb_set<base_t>()( v );
-          if(++idx < n_array) 
-          {
-            v = arr[idx];
-            if( complement ) {
-              v = ~v;
-              if( idx + 1 == n_array ) v &= hgh_bit_pttrn;
-            }
-          }
-        }
-        return npos;
-      } // idx_lsb_set
+        return   shared()
+               ? s_kernels::idx_lsb_set( arr.data(), n_array, tail_mask,
+                                         v, idx, hgh_bit_pttrn )
+               : wf().idx_lsb_set( arr.data(), v, idx, hgh_bit_pttrn );
+      }
 
 
       constexpr
       size_t
       idx_msb_set( array_t const &arr, base_t hgh_bit_pttrn ) const noexcept
       {
-          bool const complement = hgh_bit_pttrn != base_t(2);
-          index_msb_set<base_t>  msb_hlpr;
-          for( size_t i = n_array; i-- > 0; )
-          {
-              base_t val = complement ? ~(arr[i]) : arr[i];
-              if( complement && i + 1 == n_array ) val &= hgh_bit_pttrn;
-              size_t idx = msb_hlpr( val );
-              if( idx != npos ) return i * base_t_n_bits + idx;
-          }
-          return npos;
-      } // idx_msb_set
+        return   shared()
+               ? s_kernels::idx_msb_set( arr.data(), n_array, tail_mask,
+                                         hgh_bit_pttrn )
+               : wf().idx_msb_set( arr.data(), hgh_bit_pttrn );
+      }
 
   }; // struct array_funcs
 
@@ -399,6 +387,4 @@ namespace detail
 
 
 
-#undef CMPLRPOW2
-
 #endif // BITSET2_ARRAY_FUNCS_CB_HPP
@@ -14,7 +14,6 @@
 #define BITSET2_ARRAY_OPS_CB_HPP
 
 #include "bit_chars.hpp"
-#include "reverse_bits.hpp"
 #include "array_funcs.hpp"
 
 
@@ -40,11 +39,20 @@ namespace detail
     ,   all_one=         b_chars::all_one };
     using array_t=            typename h_types<T>::template array_t<n_array>;
     using zero_array_t=       typename h_types<T>::template array_t<0>;
+    using w_funcs=            word_funcs<T>;
+    using s_kernels=          shared_kernels<T>;
+
+    /// True if the runtime path should call shared_kernels<T>
+    static
+    constexpr
+    bool
+    shared() noexcept
+    { return use_shared_kernels<n_array,T>(); }
 
     constexpr
     array_ops( size_t n_shift ) noexcept
     : m_n_shift( n_shift )
-    , m_n_shift_mod( n_shift % N )
+    , m_n_shift_mod( N == 0 ? 0 : n_shift % N )
     , m_shft_div( n_shift / base_t_n_bits )
     , m_shft_mod( n_shift % base_t_n_bits )
     , m_rot_div( m_n_shift_mod / base_t_n_bits )
@@ -75,228 +83,236 @@ namespace detail
     void
     shift_left_assgn( array_t &arr ) const noexcept
     {
-      if( m_n_shift == 0 ) return;
-      
-      for( size_t c= n_words; c > 0; )
-      {
-        --c;
-        if( c >= m_shft_div )
-        {
-          auto const c2= c - m_shft_div;
-          base_t const v1= arr[c2] << m_shft_mod;
-          base_t const v2=
-            c2 == 0 ? base_t(0)
-                    : ce_right_shift( base_t(arr[c2-1] & m_shft_left_pattern),
-                                      m_shft_leftright_shift );
-          arr[c]= base_t( v1 | v2 );
-        }
-        else arr[c]= base_t(0);
-      } // for c
-      arr[n_array-1] &= hgh_bit_pattern;
-    } // shift_left_assgn
+      if( shared() )
+        s_kernels::shift_left_assgn( arr.data(), n_array, hgh_bit_pattern,
+                                     m_n_shift );
+      else
+        w_funcs( N ).shift_left_assgn( arr.data(), m_n_shift );
+    }
 
     /// Used for >>= operator.
     constexpr
     void
     shift_right_assgn( array_t &arr ) const noexcept
     {
-      if( m_n_shift == 0 ) return;
-      
-      for( size_t c= 0; c < n_words; ++c )
-      {
-        auto const c2= c + m_shft_div;
-        if( c2 < n_words )
-        {
-          base_t const v1= arr[c2] >> m_shft_mod;
-          base_t const v2=
-            ( c2 + 1 >= n_words ) ? base_t(0)
-                  : ce_left_shift( base_t( arr[c2+1] & m_shft_right_pattern ),
-                                           m_shft_leftright_shift );
-          arr[c]= v1 | v2;
-        }
-        else arr[c]= base_t(0);
-      } // for c
-      arr[n_array-1] &= hgh_bit_pattern;
-    } // shift_right_assgn
+      if( shared() )
+        s_kernels::shift_right_assgn( arr.data(), n_array, hgh_bit_pattern,
+                                      m_n_shift );
+      else
+        w_funcs( N ).shift_right_assgn( arr.data(), m_n_shift );
+    }
 
 
+    /// <<= by the constant K, all offsets and shifts are constants
+    template<size_t K>
+    static
     constexpr
-    array_t
-    rotate_left( array_t const &arr ) const noexcept
-    {
-      if( m_n_shift_mod == 0 ) return arr;
-      
-      return
-        ( n_array == 1 )
-          ? array_t{{ base_t((   base_t( arr[0] << m_n_shift_mod )
-                               | ( ce_right_shift( arr[0], N - m_n_shift_mod ) )
-                             ) & hgh_bit_pattern ) }}
-          : rotate_left_impl( arr );
-    } // rotate_left
+    void
+    shift_left_assgn_k( array_t &arr ) noexcept
+    { w_funcs( N ).plan_shift_left( arr.data(), ct_shift_plan<T,K>{} ); }
 
+    /// >>= by the constant K, see shift_left_assgn_k
+    template<size_t K>
+    static
     constexpr
-    array_t
-    flip( array_t const &arr ) const noexcept
-    { return flip_impl( arr, std::make_index_sequence<n_array>() ); }
+    void
+    shift_right_assgn_k( array_t &arr ) noexcept
+    { w_funcs( N ).plan_shift_right( arr.data(), ct_shift_plan<T,K>{} ); }
 
+    /// <<= by the amount p was made for
+    static
     constexpr
-    bool
-    all( array_t const &arr ) const noexcept
-    { return ( N > 0 ) && all_impl( n_words - 1, arr ); }
+    void
+    shift_left_assgn( array_t &arr, shift_plan<T> const &p ) noexcept
+    { w_funcs( N ).plan_shift_left( arr.data(), p ); }
 
+    /// >>= by the amount p was made for
+    static
+    constexpr
+    void
+    shift_right_assgn( array_t &arr, shift_plan<T> const &p ) noexcept
+    { w_funcs( N ).plan_shift_right( arr.data(), p ); }
 
-    /// Used for ++ operator.
+    /// \brief Rotates arr by the constant K in place. Bypasses the shared
+    /// kernels such that K propagates into the word loops.
+    template<size_t K>
+    static
     constexpr
     void
-    increment( array_t &arr ) const noexcept
-    {
-      if( N == 0 ) return;
+    rotate_assgn_k( array_t &arr ) noexcept
+    { w_funcs( N ).rotate_assgn( arr.data(), K % N ); }
 
-      size_t  c= 0;
-      for( ; c + 1 < n_words; ++c )
-      {
-        if( ( ++arr[c] ) != base_t(0) ) return;
-      }
-      ++arr[c];
-      arr[c] &= hgh_bit_pattern;
-    } // increment
+    constexpr
+    array_t
+    rotate_left( array_t const &arr ) const noexcept
+    {
+      array_t arr_r{};
+      rotate_left( arr, arr_r );
+      return arr_r;
+    } // rotate_left
 
+    /// Writes arr rotated to arr_r, which must not be arr
+    constexpr
+    void
+    rotate_left( array_t const &arr, array_t &arr_r ) const noexcept
+    {
+      if( shared() )
+        s_kernels::rotate_left( arr.data(), n_array, hgh_bit_pattern,
+                                arr_r.data(), m_n_shift );
+      else
+        w_funcs( N ).rotate_left( arr.data(), arr_r.data(), m_n_shift );
+    } // rotate_left
 
-    /// Used for -- operator.
+    /// Rotates arr left in place, used by member rotate_left
     constexpr
     void
-    decrement( array_t &arr ) const noexcept
+    rotate_assgn( array_t &arr ) const noexcept
     {
-      if( N == 0 ) return;
+      if( shared() )
+        s_kernels::rotate_assgn( arr.data(), n_array, hgh_bit_pattern,
+                                 m_n_shift );
+      else
+        w_funcs( N ).rotate_assgn( arr.data(), m_n_shift );
+    } // rotate_assgn
+
+    /// f( arr1, arr2, arr3 ), see word_funcs::ternary_op
+    template<uint8_t imm>
+    constexpr
+    array_t
+    ternary_op( array_t const &arr1, array_t const &arr2,
+                array_t const &arr3 ) const noexcept
+    {
+      array_t arr_r{};
+      ternary_op<imm>( arr1, arr2, arr3, arr_r );
+      return arr_r;
+    }
 
-      size_t  c= 0;
-      for( ; c + 1 < n_words; ++c )
-      {
-        if( ( arr[c]-- ) != base_t(0) ) return;
-      }
-      --arr[c];
-      arr[c] &= hgh_bit_pattern;
-    } // decrement
+    /// Writes f( arr1, arr2, arr3 ) to arr_r, which may be any of arr1, arr2, arr3
+    template<uint8_t imm>
+    constexpr
+    void
+    ternary_op( array_t const &arr1, array_t const &arr2,
+                array_t const &arr3, array_t &arr_r ) const noexcept
+    {
+      w_funcs( N ).template ternary_op<imm>( arr_r.data(), arr1.data(),
+                                             arr2.data(), arr3.data() );
+    }
 
-    /// Reverse bits
+    /// See word_funcs::extract_bits
     constexpr
     array_t
-    reverse( array_t const &arr ) const noexcept
+    extract_bits( array_t const &src, array_t const &mask ) const noexcept
     {
-      return   n_array == 1
-             ? array_t{{ base_t( reverse_bits<base_t>()(arr[0]) >> n_m_mod ) }}
-             : reverse_impl( arr, std::make_index_sequence<n_array>() );
-    } // reverse
+      array_t arr_r{};
+      w_funcs( N ).extract_bits( arr_r.data(), src.data(), mask.data() );
+      return arr_r;
+    }
 
+    /// See word_funcs::deposit_bits
+    constexpr
+    array_t
+    deposit_bits( array_t const &src, array_t const &mask ) const noexcept
+    {
+      array_t arr_r{};
+      w_funcs( N ).deposit_bits( arr_r.data(), src.data(), mask.data() );
+      return arr_r;
+    }
 
-    //****************************************************
+    /// \brief Bits [n_shift, n_shift + M) of arr as the words of a
+    /// bitset2<M,T>, see word_funcs::extract_field
+    template<size_t M>
+    constexpr
+    typename array_ops<M,T>::array_t
+    extract_field( array_t const &arr ) const noexcept
+    {
+      typename array_ops<M,T>::array_t arr_r{};
+      w_funcs( N ).extract_field( arr.data(), arr_r.data(), M,
+                                  m_shft_div, m_shft_mod );
+      return arr_r;
+    }
 
+    /// Overwrites bits [n_shift, n_shift + M) of arr with field
+    template<size_t M>
+    constexpr
+    void
+    insert_field( array_t &arr,
+                  typename array_ops<M,T>::array_t const &field ) const noexcept
+    {
+      w_funcs( N ).insert_field( arr.data(), field.data(), M,
+                                 m_shft_div, m_shft_mod );
+    }
 
     constexpr
-    bool
-    all_impl( size_t idx, array_t const &arr ) const noexcept
+    array_t
+    flip( array_t arr ) const noexcept
     {
-      return    h_all( idx, arr )
-             && ( ( idx == 0 ) ? true : all_impl( idx - 1, arr ) );
+      if( shared() )
+        s_kernels::flip_assgn( arr.data(), n_array, hgh_bit_pattern );
+      else
+        w_funcs( N ).flip_assgn( arr.data() );
+      return arr;
     }
 
     constexpr
     bool
-    h_all( size_t idx, array_t const &arr ) const noexcept
+    all( array_t const &arr ) const noexcept
     {
-      return ( idx + 1 ==  n_words ) ? ( arr[idx] == hgh_bit_pattern )
-                                     : ( arr[idx] == all_one );
+      return   shared() ? s_kernels::all( arr.data(), n_array, hgh_bit_pattern )
+             : w_funcs( N ).all( arr.data() );
     }
 
 
+    /// Used for ++ operator.
     constexpr
-    array_t
-    rotate_left_impl( array_t const & arr ) const noexcept
+    void
+    increment( array_t &arr ) const noexcept
     {
-      size_t const rot_r_div = (N - m_n_shift_mod) / base_t_n_bits;
-      size_t const rot_r_mod = (N - m_n_shift_mod) % base_t_n_bits;
-      size_t const bits_last = (mod_val == 0) ? base_t_n_bits : mod_val;
-      array_t      arr_r{};
-      size_t       c = 0;
-      
-      size_t const h1 = (bits_last < rot_r_mod) ? 2 : 1;
-      for( ; c + h1 + rot_r_div < n_words; ++c )
-      {
-        size_t i1 = c + rot_r_div;
-        size_t i2 = i1 + 1;
-        base_t v1 = ce_right_shift( arr[i1], rot_r_mod );
-        base_t v2 = ce_left_shift(  arr[i2], base_t_n_bits - rot_r_mod );
-        arr_r[c] = base_t( v1 | v2 );
-      } // for c
-      
-      if( c < n_words && bits_last < rot_r_mod )
-      {
-        base_t v1 = ce_right_shift( arr[n_words-2], rot_r_mod );
-        base_t v2 = ce_left_shift(  arr[n_words-1], base_t_n_bits - rot_r_mod );
-        base_t v3 = ce_left_shift( arr[0], base_t_n_bits - rot_r_mod + bits_last );
-        arr_r[c++] = base_t( v1 | v2 | v3 );
-      }
-      
-      if( c < n_words && bits_last > rot_r_mod )
-      {
-        base_t v1 = ce_right_shift( arr[n_words-1], rot_r_mod );
-        base_t v2 = ce_left_shift(  arr[0], bits_last - rot_r_mod );
-        arr_r[c++] = base_t( v1 | v2 );
-      }
-      
-      for( ; c < n_words; ++c )
-      {
-        size_t i1 = c - m_rot_div;
-        size_t i2 = i1 - 1;
-        base_t v1 = ce_left_shift(  arr[i1], m_rot_mod );
-        base_t v2 = ce_right_shift( arr[i2], base_t_n_bits - m_rot_mod );
-        arr_r[c] = base_t( v1 | v2 );
-      } // for c
-      
-      arr_r[n_array-1] &= hgh_bit_pattern;
-      return arr_r;
-    } // rotate_left_impl
+      if( shared() ) s_kernels::increment( arr.data(), n_array, hgh_bit_pattern );
+      else           w_funcs( N ).increment( arr.data() );
+    }
 
 
-    template<size_t ... S>
-    constexpr
-    array_t
-    flip_impl( array_t const &arr, std::index_sequence<S...> ) const noexcept
-    { return {{ h_flip( S, arr )... }}; }
-
+    /// Used for -- operator.
     constexpr
-    base_t
-    h_flip( size_t idx, array_t const &arr ) const noexcept
+    void
+    decrement( array_t &arr ) const noexcept
     {
-      return   ( idx >= n_words ) ? base_t(0)
-             :   ( ~arr[idx] )
-               & ( (idx+1 == n_words) ? hgh_bit_pattern : all_one );
+      if( shared() ) s_kernels::decrement( arr.data(), n_array, hgh_bit_pattern );
+      else           w_funcs( N ).decrement( arr.data() );
     }
 
-
-    template<size_t ... S>
+    /// Reverse bits
     constexpr
     array_t
-    reverse_impl( array_t const &arr, std::index_sequence<S...> ) const noexcept
-    { return {{ h_reverse( S, arr )... }}; }
+    reverse( array_t const &arr ) const noexcept
+    {
+      array_t ret_val{};
+      reverse( arr, ret_val );
+      return ret_val;
+    } // reverse
 
+    /// Writes arr with bits reversed to ret_val, which must not be arr
     constexpr
-    base_t
-    h_reverse( size_t idx, array_t const &arr ) const noexcept
+    void
+    reverse( array_t const &arr, array_t &ret_val ) const noexcept
     {
-      return   idx + 1 == n_words
-             ? base_t( reverse_bits<base_t>()( arr[0] ) >> n_m_mod )
-             : reverse_bits<base_t>()( h2_reverse( idx, arr ) );
-    }
+      if( shared() )
+        s_kernels::reverse( arr.data(), n_array, hgh_bit_pattern,
+                            ret_val.data() );
+      else
+        w_funcs( N ).reverse( arr.data(), ret_val.data() );
+    } // reverse
 
+    /// Reverses the bits of arr in place
     constexpr
-    base_t
-    h2_reverse( size_t idx, array_t const &arr ) const noexcept
+    void
+    reverse_assgn( array_t &arr ) const noexcept
     {
-      return   mod_val == 0 ? arr[n_words-idx-1]
-             : base_t(   ( arr[n_words-idx-1] << n_m_mod )
-                       | ( arr[n_words-idx-2] >> mod_val ) );
-    }
+      if( shared() )
+        s_kernels::reverse_assgn( arr.data(), n_array, hgh_bit_pattern );
+      else
+        w_funcs( N ).reverse_assgn( arr.data() );
+    } // reverse_assgn
 
 
     size_t const     m_n_shift;
@@ -17,16 +17,29 @@
 #include "array_add.hpp"
 #include "ullong2array.hpp"
 #include "array2u_long_t.hpp"
+#include "set_bits_view.hpp"
+#include "storage_policy.hpp"
 #include <bitset>
 #include <stdexcept>
 
+#if __cplusplus >= 202002L
+# include <compare>
+# ifdef __cpp_lib_span
+#  include <span>
+#  define CMPLRSPAN
+# endif
+# ifdef __cpp_lib_three_way_comparison
+#  define CMPLRSPACESHIP
+# endif
+#endif
+
 
 namespace Bitset2
 {
 namespace detail
 {
 
-template<size_t N,class T>
+template<size_t N,class T,class S= inline_storage>
 class bitset2_impl
 {
   using b_chars=                     bit_chars<N,T>;
@@ -40,8 +53,15 @@ public:
   using ULLONG_t=    typename b_chars::ULLONG_t;
   using LRGST_t=     typename b_chars::LRGST_t;
   using array_t=     typename h_types<T>::template array_t<n_array>;
+  using storage_t=   S;
 
 protected:
+  using holder_t=    storage_holder<S,array_t>;
+
+  /// \brief True if the words are held inside the object. Otherwise
+  /// they are allocated, which may throw.
+  enum : bool { is_inline= holder_t::is_inline };
+
   enum : size_t
   { n_words=         b_chars::n_words
   , ulong_n_bits=    b_chars::ulong_n_bits
@@ -62,18 +82,18 @@ protected:
 
   /* ----------------------------------------------------------------------- */
   constexpr
-  bitset2_impl() noexcept
+  bitset2_impl() noexcept( is_inline )
   {}
 
   constexpr
-  bitset2_impl( bitset2_impl const & ) noexcept= default;
+  bitset2_impl( bitset2_impl const & ) noexcept( is_inline )= default;
 
   constexpr
   bitset2_impl( bitset2_impl && ) noexcept= default;
 
   constexpr
   bitset2_impl &
-  operator=( bitset2_impl const & ) noexcept= default;
+  operator=( bitset2_impl const & ) noexcept( is_inline )= default;
 
   constexpr
   bitset2_impl &
@@ -81,24 +101,32 @@ protected:
 
   explicit
   constexpr
-  bitset2_impl( LRGST_t v ) noexcept
-  : m_value( lrgst2array<N,T>()( v ) )
+  bitset2_impl( LRGST_t v ) noexcept( is_inline )
+  : m_value( gen_tag{}, [v]{ return lrgst2array<N,T>()( v ); } )
   {}
 
   template<size_t n,class Tsrc>
   explicit
   constexpr
-  bitset2_impl( std::array<Tsrc,n> const & value ) noexcept
-  : m_value( a2a<n,Tsrc>()( hgh_bit_pattern, value ) )
+  bitset2_impl( std::array<Tsrc,n> const & value ) noexcept( is_inline )
+  : m_value( gen_tag{},
+             [&value]{ return a2a<n,Tsrc>()( hgh_bit_pattern, value ); } )
+  {}
+
+  /// Constructs the words from the result of f() without a copy
+  template<class F>
+  constexpr
+  bitset2_impl( gen_tag, F f ) noexcept( is_inline )
+  : m_value( gen_tag{}, f )
   {}
 
   explicit
-  bitset2_impl( const std::bitset<N> &bs ) noexcept
+  bitset2_impl( const std::bitset<N> &bs ) noexcept( is_inline )
   {
     if( N == 0 ) return;
     if( ullong_n_bits >= base_t_n_bits && n_words == 1 )
     {
-      m_value[0]= bs.to_ullong();
+      m_value.get()[0]= bs.to_ullong();
       return;
     }
 
@@ -114,7 +142,7 @@ protected:
         val <<= 1;
         if( bs.test( test_bit ) ) val |= base_t(1);
       } // for bit_ct
-      m_value[ct]= val;
+      m_value.get()[ct]= val;
       offset += base_t_n_bits;
     } // for ct
   } // bitset2_impl( const std::bitset<N> &bs )
@@ -154,7 +182,7 @@ protected:
   constexpr
   array_t &
   get_data() noexcept
-  { return m_value; }
+  { return m_value.get(); }
 
   constexpr
   bool
@@ -164,7 +192,7 @@ protected:
   constexpr
   bool
   test_noexcept( size_t bit ) const noexcept
-  { return m_value[bit / base_t_n_bits] & ( T(1) << ( bit % base_t_n_bits ) ); }
+  { return data()[bit / base_t_n_bits] & ( T(1) << ( bit % base_t_n_bits ) ); }
 
   constexpr
   bitset2_impl &
@@ -183,8 +211,8 @@ protected:
     if( N > 0 )
     {
       size_t c= 0;
-      for( ; c < n_words - 1; ++c ) m_value[c]= ~base_t(0);
-      m_value[c]= hgh_bit_pattern;
+      for( ; c < n_words - 1; ++c ) m_value.get()[c]= ~base_t(0);
+      m_value.get()[c]= hgh_bit_pattern;
     }
     return *this;
   } // set
@@ -193,7 +221,7 @@ protected:
   bitset2_impl &
   reset() noexcept
   {
-    for( size_t c= 0; c < n_array; ++c ) m_value[c]= base_t(0);
+    for( size_t c= 0; c < n_array; ++c ) m_value.get()[c]= base_t(0);
     return *this;
   }
 
@@ -210,7 +238,7 @@ protected:
   bitset2_impl &
   flip_noexcept( size_t bit ) noexcept
   {
-    m_value[bit / base_t_n_bits] ^= ( base_t(1) << ( bit % base_t_n_bits ) );
+    m_value.get()[bit / base_t_n_bits] ^= ( base_t(1) << ( bit % base_t_n_bits ) );
     return *this;
   }
 
@@ -230,17 +258,24 @@ protected:
     if( N > 0 )
     {
       size_t c= 0;
-      for( ; c < n_words - 1; ++c ) m_value[c] ^= ~base_t(0);
-      m_value[c] ^= hgh_bit_pattern;
+      for( ; c < n_words - 1; ++c ) m_value.get()[c] ^= ~base_t(0);
+      m_value.get()[c] ^= hgh_bit_pattern;
     }
     return *this;
   } // flip
 
+  /// Throws out_of_range unless lo <= hi <= N
+  static
+  constexpr
+  void
+  check_range( size_t lo, size_t hi, char const *msg )
+  { if( lo > hi || hi > N ) throw std::out_of_range( msg ); }
+
 public:
   constexpr
   array_t const &
   data() const noexcept
-  { return m_value; }
+  { return m_value.get(); }
 
   constexpr
   ULONG_t
@@ -248,10 +283,10 @@ public:
   {
     using a2l= array2u_long_t<N,T,ULONG_t>;
     return  ( N == 0 ) ? 0ul
-            : a2l().check_overflow( m_value )
+            : a2l().check_overflow( m_value.get() )
               ? throw std::overflow_error( "Cannot convert bitset2 "
                                            "to unsigned long" )
-              : a2l()( m_value );
+              : a2l()( m_value.get() );
   } // to_ulong
 
   constexpr
@@ -260,10 +295,10 @@ public:
   {
     using a2l= array2u_long_t<N,T,ULLONG_t>;
     return  ( N == 0 ) ? 0ull
-            : a2l().check_overflow( m_value )
+            : a2l().check_overflow( m_value.get() )
               ? throw std::overflow_error( "Cannot convert bitset2 "
                                            "to unsigned long long" )
-              : a2l()( m_value );
+              : a2l()( m_value.get() );
   } // to_ullong
   
 #ifdef __SIZEOF_INT128__
@@ -273,10 +308,10 @@ public:
   {
     using a2l= array2u_long_t<N,T,LRGST_t>;
     return  ( N == 0 ) ? LRGST_t(0)
-            : a2l().check_overflow( m_value )
+            : a2l().check_overflow( m_value.get() )
               ? throw std::overflow_error( "Cannot convert bitset2 "
                                            "to unsigned __int128" )
-              : a2l()( m_value );
+              : a2l()( m_value.get() );
   } // to_u128
 #endif
 
@@ -293,9 +328,9 @@ public:
   void
   set_noexcept( size_t bit, bool value= true ) noexcept
   {
-    if( value ) m_value[bit / base_t_n_bits]
+    if( value ) m_value.get()[bit / base_t_n_bits]
                    |=  base_t(   base_t(1) << ( bit % base_t_n_bits )  );
-    else        m_value[bit / base_t_n_bits]
+    else        m_value.get()[bit / base_t_n_bits]
                    &=  base_t(~( base_t(1) << ( bit % base_t_n_bits ) ));
   }
 
@@ -306,10 +341,10 @@ public:
     auto const dv= bit / base_t_n_bits;
     auto const md= bit % base_t_n_bits;
     auto const pttrn= ( base_t(1) << md );
-    auto const ret_val= bool( m_value[dv] & pttrn );
+    auto const ret_val= bool( m_value.get()[dv] & pttrn );
 
-    if( value ) m_value[dv] |=  pttrn;
-    else        m_value[dv] &= ~pttrn;
+    if( value ) m_value.get()[dv] |=  pttrn;
+    else        m_value.get()[dv] &= ~pttrn;
 
     return ret_val;
   } // test_set_noexcept
@@ -317,7 +352,7 @@ public:
   constexpr
   bool
   none() const noexcept
-  { return detail::array_funcs<n_array,T>().none( m_value ); }
+  { return detail::array_funcs<n_array,T>().none( m_value.get() ); }
 
   constexpr
   bool
@@ -327,18 +362,18 @@ public:
   constexpr
   bool
   all() const noexcept
-  { return ( N > 0 ) && detail::array_ops<N,T>( 0 ).all( m_value ); }
+  { return ( N > 0 ) && detail::array_ops<N,T>( 0 ).all( m_value.get() ); }
 
   constexpr
   size_t
   count() const noexcept
-  { return detail::array_funcs<n_array,T>().count( m_value ); }
+  { return detail::array_funcs<n_array,T>().count( m_value.get() ); }
   
   /// True if exactly one bit set.
   constexpr
   bool
   has_single_bit() const noexcept
-  { return detail::array_funcs<n_array,T>().has_single_bit( m_value ); }
+  { return detail::array_funcs<n_array,T>().has_single_bit( m_value.get() ); }
 
   /// \brief Returns index of first (least significant) bit set.
   /// Returns npos if all bits are zero.
@@ -346,7 +381,7 @@ public:
   size_t
   find_first() const noexcept
   {
-    return detail::array_funcs<n_array,T>().idx_lsb_set(m_value, m_value[0], 0, base_t(2));
+    return detail::array_funcs<n_array,T>().idx_lsb_set(data(), data()[0], 0, base_t(2));
   }
 
   /// \brief Returns index of first (least significant) bit unset.
@@ -355,7 +390,7 @@ public:
   size_t
   find_first_zero() const noexcept
   {
-    return detail::array_funcs<n_array,T>().idx_lsb_set(m_value, ~m_value[0], 0, hgh_bit_pattern);
+    return detail::array_funcs<n_array,T>().idx_lsb_set(data(), ~data()[0], 0, hgh_bit_pattern);
   }
   
   /// \brief Returns index of last (most significant) bit set.
@@ -364,7 +399,7 @@ public:
   size_t
   find_last() const noexcept
   {
-    return detail::array_funcs<n_array,T>().idx_msb_set(m_value, base_t(2));
+    return detail::array_funcs<n_array,T>().idx_msb_set(m_value.get(), base_t(2));
   }
   
   /// \brief Returns index of last (most significant) bit unset.
@@ -373,7 +408,7 @@ public:
   size_t
   find_last_zero() const noexcept
   {
-    return detail::array_funcs<n_array,T>().idx_msb_set(m_value, hgh_bit_pattern);
+    return detail::array_funcs<n_array,T>().idx_msb_set(data(), hgh_bit_pattern);
   }
 
   /// \brief Returns index of next (> idx) bit set.
@@ -390,8 +425,8 @@ public:
       : idx + 1 == N
         ? npos
         : detail::array_funcs<n_array,T>()
-            .idx_lsb_set( m_value,
-                          base_t( m_value[arr_idx] & ce_left_shift(T(~T(0)),idx_mod) ),
+            .idx_lsb_set( m_value.get(),
+                          base_t( data()[arr_idx] & ce_left_shift(T(~T(0)),idx_mod) ),
                           arr_idx,
                           base_t(2) );
   } // find_next
@@ -410,16 +445,112 @@ public:
       : idx + 1 == N
         ? npos
         : detail::array_funcs<n_array,T>()
-            .idx_lsb_set( m_value,
-                          base_t( ~(m_value[arr_idx]) & ce_left_shift(T(~T(0)),idx_mod) ),
+            .idx_lsb_set( m_value.get(),
+                          base_t( ~(data()[arr_idx]) & ce_left_shift(T(~T(0)),idx_mod) ),
                           arr_idx,
                           hgh_bit_pattern );
   } // find_next_zero
 
+  /// \brief Returns number of bits set below position idx.
+  /// Throws out_of_range if idx > N.
+  constexpr
+  size_t
+  rank( size_t idx ) const
+  {
+    return idx > N
+      ? throw std::out_of_range( "bitset2: rank index out of range" )
+      : detail::array_funcs<n_array,T>().rank( m_value.get(), idx );
+  }
+
+  /// \brief Returns the number of bits set in [lo, hi), touching only
+  /// the words overlapping the range. Throws out_of_range unless
+  /// lo <= hi <= N.
+  constexpr
+  size_t
+  count_range( size_t lo, size_t hi ) const
+  {
+    check_range( lo, hi, "bitset2: count_range out of range" );
+    return detail::word_funcs<T>( N ).count_range( m_value.get().data(), lo, hi );
+  }
+
+  /// \brief Returns true if any bit in [lo, hi) is set, see count_range.
+  /// Throws out_of_range unless lo <= hi <= N.
+  constexpr
+  bool
+  any_in_range( size_t lo, size_t hi ) const
+  {
+    check_range( lo, hi, "bitset2: any_in_range out of range" );
+    return detail::word_funcs<T>( N ).any_in_range( m_value.get().data(), lo, hi );
+  }
+
+  /// \brief Returns index of k-th (counting from zero) bit set.
+  /// Returns npos if less than k+1 bits are set.
+  constexpr
+  size_t
+  select( size_t k ) const noexcept
+  { return detail::array_funcs<n_array,T>().select( m_value.get(), k ); }
+
+  /// \brief Returns a range of the indices of all set bits in
+  /// ascending order. The range refers to *this.
+  constexpr
+  set_bits_view<n_array,T,false>
+  set_bits() const noexcept
+  { return set_bits_view<n_array,T,false>( m_value.get() ); }
+
+  /// \brief Returns a range of the indices of all set bits in
+  /// descending order. The range refers to *this.
+  constexpr
+  set_bits_view<n_array,T,true>
+  set_bits_reverse() const noexcept
+  { return set_bits_view<n_array,T,true>( m_value.get() ); }
+
+  /// \brief Writes the indices of all set bits in ascending order to out,
+  /// which must provide room for count() values. Returns the number
+  /// of indices written. IdxT=uint16_t requires N <= 65536.
+  template<class IdxT,
+           typename std::enable_if<
+                        std::is_same<IdxT,uint32_t>::value
+                    || ( std::is_same<IdxT,uint16_t>::value && N <= 65536 )
+                                  >::type* = nullptr>
+  constexpr
+  size_t
+  decode_positions( IdxT *out ) const noexcept
+  {
+    static_assert( N <= size_t(1) << 32, "Indices exceed uint32_t" );
+    return detail::array_funcs<n_array,T>()
+                  .decode_positions( m_value.get(), out, npos );
+  }
+
+#ifdef CMPLRSPAN
+  /// \brief Writes the indices of the set bits in ascending order to out.
+  /// Stops if out is full. Returns the number of indices written.
+  /// Not a template, such that anything convertible to the span
+  /// (std::vector, fixed extent spans, ...) can be passed.
+  constexpr
+  size_t
+  decode_positions( std::span<uint32_t> out ) const noexcept
+  {
+    static_assert( N <= size_t(1) << 32, "Indices exceed uint32_t" );
+    return detail::array_funcs<n_array,T>()
+                  .decode_positions( m_value.get(), out.data(), out.size() );
+  }
+
+  /// See above, requires N <= 65536
+  template<size_t M= N,
+           typename std::enable_if<( M <= 65536 )>::type* = nullptr>
+  constexpr
+  size_t
+  decode_positions( std::span<uint16_t> out ) const noexcept
+  {
+    return detail::array_funcs<n_array,T>()
+                  .decode_positions( m_value.get(), out.data(), out.size() );
+  }
+#endif
+
   constexpr
   bool
   operator==( bitset2_impl const &v2 ) const noexcept
-  { return detail::array_funcs<n_array,T>().equal( m_value, v2.m_value ); }
+  { return detail::array_funcs<n_array,T>().equal( data(), v2.data() ); }
 
   constexpr
   bool
@@ -429,7 +560,7 @@ public:
   constexpr
   bool
   operator<( bitset2_impl const &v2 ) const noexcept
-  { return detail::array_funcs<n_array,T>().less_than( m_value, v2.m_value ); }
+  { return detail::array_funcs<n_array,T>().less_than( data(), v2.data() ); }
 
   constexpr
   bool
@@ -439,13 +570,26 @@ public:
   constexpr
   bool
   operator>( bitset2_impl const &v2 ) const noexcept
-  { return detail::array_funcs<n_array,T>().less_than(v2.m_value, m_value); }
+  { return detail::array_funcs<n_array,T>().less_than(v2.data(), data()); }
 
   constexpr
   bool
   operator>=( bitset2_impl const &v2 ) const noexcept
   { return ! ( *this < v2 ); }
 
+#ifdef CMPLRSPACESHIP
+  /// Consistent with ==, <, etc. Compares in a single pass.
+  constexpr
+  std::strong_ordering
+  operator<=>( bitset2_impl const &v2 ) const noexcept
+  {
+    auto const c= detail::array_funcs<n_array,T>().compare( data(), v2.data() );
+    return   c < 0 ? std::strong_ordering::less
+           : c > 0 ? std::strong_ordering::greater
+                   : std::strong_ordering::equal;
+  }
+#endif
+
   explicit
   operator std::bitset<N>() const
   {
@@ -459,7 +603,7 @@ public:
     return ret_val;
   }
 private:
-  array_t   m_value= (detail::gen_empty_array<n_array,T>)();
+  holder_t  m_value;
 }; // class bitset2_impl
 
 
@@ -468,4 +612,7 @@ private:
 
 
 
+#undef CMPLRSPACESHIP
+#undef CMPLRSPAN
+
 #endif // BITSET2_IMPL_CB_HPP
@@ -20,36 +20,65 @@
 # include <bit>
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+# define CMPLRBUILTIN 1
+#else
+# define CMPLRBUILTIN 0
+#endif
+
 
 namespace Bitset2
 {
 namespace detail
 {
 
+  /// \brief Returns the number of bits set in val.
+  /// Portable version, which recurses once per bit set.
+  template<class T>
+  constexpr
+  inline
+  size_t
+  count_bits_generic( T val, size_t count= 0 ) noexcept
+  {
+    return
+      ( val == T(0) )
+               ? count
+               : count_bits_generic( T(val & T( val - T(1) )), // clears lowest set bit
+                                     count + 1 );
+  }
+
+
   /// Returns the number of bits set in val
   template<class T>
   constexpr
   inline
   size_t
-  count_bits( T val, size_t count= 0 ) noexcept
+  count_bits( T val ) noexcept
   {
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+      // Two 64 bit popcounts
+      return   count_bits( (unsigned long long)( val ) )
+             + count_bits( (unsigned long long)( val >> 64 ) );
+    else
+#endif
+    {
 #ifdef __cpp_lib_bitops
-# ifdef __SIZEOF_INT128__
-    if constexpr( !std::is_same_v<T,unsigned __int128> )
-# endif
       return std::popcount(val);
+#elif CMPLRBUILTIN
+      // Constant folded by GCC and Clang, hence usable in C++17 constexpr
+      return size_t( __builtin_popcountll( (unsigned long long)val ) );
+#else
+      return count_bits_generic( val );
 #endif
-    return
-      ( val == T(0) )
-               ? count
-               : count_bits( T(val & T( val - T(1) )), // clears lowest set bit
-                             count + 1 );
+    }
   }
 
 } // namespace detail
 } // namespace Bitset2
 
 
+#undef CMPLRBUILTIN
 
 
 #endif // BITSET2_COUNT_BITS_CB_HPP
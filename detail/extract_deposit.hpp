@@ -0,0 +1,147 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_EXTRACT_DEPOSIT_CB_HPP
+#define BITSET2_EXTRACT_DEPOSIT_CB_HPP
+
+
+#include "h_types.hpp"
+#include "count_bits.hpp"
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__BMI2__) && ( defined(__GNUC__) || defined(__clang__) )
+# include <immintrin.h>
+# define CMPLRPDEP
+#endif
+
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+
+/// \brief Bit extract (pext) and deposit (pdep) on a single word
+template<class T>
+struct extract_deposit
+{
+  enum : size_t { n_bits= sizeof(T) * CHAR_BIT };
+
+  /// Loops over the bits set in mask
+  constexpr
+  T
+  extract_impl( T val, T mask ) const noexcept
+  {
+    T ret_val= T(0);
+    for( T bit= T(1); mask != T(0); mask &= T( mask - 1 ), bit= T( bit << 1 ) )
+      ret_val |= ( val & mask & T( ~mask + 1 ) ) != T(0) ? bit : T(0);
+    return ret_val;
+  } // extract_impl
+
+  /// Loops over the bits set in mask
+  constexpr
+  T
+  deposit_impl( T val, T mask ) const noexcept
+  {
+    T ret_val= T(0);
+    for( ; mask != T(0); mask &= T( mask - 1 ), val= T( val >> 1 ) )
+      ret_val |= T( mask & T( ~mask + 1 ) & T( T(0) - T( val & T(1) ) ) );
+    return ret_val;
+  } // deposit_impl
+
+#ifdef __SIZEOF_INT128__
+  /// unsigned __int128: Extract from both halves and concatenate
+  constexpr
+  T
+  extract_halves( T val, T mask ) const noexcept
+  {
+    using ull_t= unsigned long long;
+    extract_deposit<ull_t> const ed;
+    auto const lo= ed.extract( ull_t( val ), ull_t( mask ) );
+    auto const hi= ed.extract( ull_t( val >> 64 ), ull_t( mask >> 64 ) );
+    return T( lo ) | ( T( hi ) << count_bits( ull_t( mask ) ) );
+  }
+
+  /// unsigned __int128: Deposit the lowest bits of val into the lower half
+  constexpr
+  T
+  deposit_halves( T val, T mask ) const noexcept
+  {
+    using ull_t= unsigned long long;
+    extract_deposit<ull_t> const ed;
+    auto const lo= ed.deposit( ull_t( val ), ull_t( mask ) );
+    auto const hi= ed.deposit( ull_t( val >> count_bits( ull_t( mask ) ) ),
+                               ull_t( mask >> 64 ) );
+    return T( lo ) | ( T( hi ) << 64 );
+  }
+#endif
+
+  /// \brief Gathers the bits of val at the positions of the bits set in
+  /// mask into the lowest bits of the result, like BMI2's pext
+  constexpr
+  T
+  extract( T val, T mask ) const noexcept
+  {
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+                                         return extract_halves( val, mask );
+    else
+#endif
+#ifdef CMPLRPDEP
+    if constexpr( n_bits <= 64 )
+    {
+      if( !ce_is_constant_evaluated() )
+        return T( _pext_u64( (unsigned long long)val, (unsigned long long)mask ) );
+      return extract_impl( val, mask );
+    }
+    else
+#endif
+    return extract_impl( val, mask );
+  } // extract
+
+  /// \brief Scatters the lowest bits of val to the positions of the bits
+  /// set in mask, like BMI2's pdep
+  constexpr
+  T
+  deposit( T val, T mask ) const noexcept
+  {
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+                                         return deposit_halves( val, mask );
+    else
+#endif
+#ifdef CMPLRPDEP
+    if constexpr( n_bits <= 64 )
+    {
+      if( !ce_is_constant_evaluated() )
+        return T( _pdep_u64( (unsigned long long)val, (unsigned long long)mask ) );
+      return deposit_impl( val, mask );
+    }
+    else
+#endif
+    return deposit_impl( val, mask );
+  } // deposit
+}; // struct extract_deposit
+
+
+
+} // namespace detail
+} // namespace Bitset2
+
+
+#undef CMPLRPDEP
+
+#endif // BITSET2_EXTRACT_DEPOSIT_CB_HPP
@@ -18,6 +18,7 @@
 #include <climits>
 #include <type_traits>
 #include <cstddef>
+#include <cstdint>
 
 
 namespace Bitset2
@@ -65,6 +66,27 @@ namespace detail
     }; // struct h_types
 
 
+    /// Binary operator type
+    enum class bitwise_op_type { or_op, and_op, xor_op, sdiff_op };
+
+
+    /// \brief Returns true if called during constant evaluation.
+    /// Returns true as well if the compiler cannot tell, such that
+    /// the constexpr code paths get used.
+    constexpr
+    bool
+    ce_is_constant_evaluated() noexcept
+    {
+#if defined(__cpp_lib_is_constant_evaluated)
+      return std::is_constant_evaluated();
+#elif defined(__GNUC__) && ( __GNUC__ >= 9 || defined(__clang__) )
+      return __builtin_is_constant_evaluated();
+#else
+      return true;
+#endif
+    }
+
+
     template<class T>
     constexpr
     T
@@ -96,13 +118,46 @@ namespace detail
 
 
 
-    template<size_t n_array,class T,size_t ... S>
-    inline constexpr
-    typename h_types<T>::template array_t<n_array>
-    gen_empty_array_impl( std::index_sequence<S...> ) noexcept
+    /// \brief Boolean function of two inputs given by its truth table:
+    /// Each bit of the result is bit ( b << 1 | c ) of tbl.
+    template<uint8_t tbl,class T>
+    constexpr
+    T
+    ce_binary_fn( T b, T c ) noexcept
     {
-      return
-        typename h_types<T>::template array_t<n_array>{{ ( T(S) & T(0) ) ... }};
+      switch( tbl & 0x0F )
+      {
+        case 0x0: return T(0);
+        case 0x1: return T( ~( b | c ) );
+        case 0x2: return T( ~b & c );
+        case 0x3: return T( ~b );
+        case 0x4: return T( b & ~c );
+        case 0x5: return T( ~c );
+        case 0x6: return T( b ^ c );
+        case 0x7: return T( ~( b & c ) );
+        case 0x8: return T( b & c );
+        case 0x9: return T( ~( b ^ c ) );
+        case 0xA: return c;
+        case 0xB: return T( ~b | c );
+        case 0xC: return b;
+        case 0xD: return T( b | ~c );
+        case 0xE: return T( b | c );
+        default:  return T( ~T(0) );
+      } // switch
+    } // ce_binary_fn
+
+    /// \brief Boolean function of three inputs given by its truth table:
+    /// Each bit of the result is bit ( a << 2 | b << 1 | c ) of imm,
+    /// as for AVX-512's vpternlog. Computed by expansion on a into
+    /// the functions f0 (a == 0) and f1 (a == 1) of b and c.
+    template<uint8_t imm,class T>
+    constexpr
+    T
+    ce_ternary( T a, T b, T c ) noexcept
+    {
+      T const f0= ce_binary_fn<uint8_t( imm & 0x0F )>( b, c );
+      T const f1= ce_binary_fn<uint8_t( imm >> 4 )>( b, c );
+      return T( f0 ^ ( a & ( f0 ^ f1 ) ) );
     }
 
 
@@ -111,10 +166,7 @@ namespace detail
     inline constexpr
     typename h_types<T>::template array_t<n_array>
     gen_empty_array() noexcept
-    {
-      return
-        gen_empty_array_impl<n_array,T>( std::make_index_sequence<n_array>() );
-    } // gen_empty_array
+    { return typename h_types<T>::template array_t<n_array>{}; }
 
 } // namespace detail
 } // namespace Bitset2
@@ -14,11 +14,13 @@
 #define BITSET2_HASH_CB_HPP
 
 #include "h_types.hpp"
+#include "bit_chars.hpp"
+#include "shared_kernels.hpp"
 
 #include <functional>
 #include <array>
 #include <climits>
-#include <algorithm>
+#include <cstdint>
 
 
 namespace Bitset2
@@ -27,92 +29,136 @@ namespace detail
 {
 
 
-template<size_t n_words,class T>
-struct hash_impl
+/// \brief 64 bit hash of the n_bits lowest bits of n_array words of
+/// type T, in the spirit of wyhash
+/// (W. Yi, https://github.com/wangyi-fudan/wyhash).
+/// The bits are read as 64 bit lanes, lane i holding bits [64i,64i+64).
+/// Lanes are assembled by shifts, hence the result neither depends on
+/// T nor on the endianness of the platform and can be persisted.
+template<class T>
+struct hash_words
 {
   using    base_t=        T;
-  using    result_type=   std::size_t;
-  using    array_t=       typename h_types<T>::template array_t<n_words>;
+  using    u64_t=         uint64_t;
 
   enum : size_t
-  { size_t_bits=    sizeof(result_type) * CHAR_BIT   ///< #bits in result_type
-  , base_t_n_bits=  h_types<T>::base_t_n_bits        ///< #bits in T
-  , bits_mod=       base_t_n_bits % size_t_bits
-  , bits_div=       base_t_n_bits / size_t_bits + ( bits_mod > 0 )
-  , size_t_mod=     size_t_bits % base_t_n_bits
-  , size_t_div=     size_t_bits / base_t_n_bits
+  { base_t_n_bits=  h_types<T>::base_t_n_bits        ///< #bits in T
   };
 
-  enum : bool
-  { easy_bits=  ( size_t_bits >= base_t_n_bits )
-  , easy_ratio= ( size_t_mod == 0 )
+  enum : u64_t
+  { p0= 0xa0761d6478bd642full
+  , p1= 0xe7037ed1a0b428dbull
+  , p2= 0x8ebc6af09c88c6e3ull
+  , p3= 0x589965cc75374cc3ull
   };
 
-  result_type
-  operator()( array_t const & arr ) const noexcept
-  {
-    if( n_words == 0 ) return 0;
-    if( n_words == 1 )
-    {
-      if( easy_bits ) return arr[0];
-      return to_result_t( arr[0] );
-    } // if n_words == 1
-
-    return cmpsd_hash( arr );
-  }
-
-  result_type
-  to_result_t( base_t a ) const noexcept
+  /// 64 bit hash of arr, depending on seed
+  static
+  constexpr
+  u64_t
+  hash64( T const *arr, size_t n_array, size_t n_bits, u64_t seed ) noexcept
   {
-    result_type ret_val= 0;
-    size_t      shft=    0;
-    for( size_t c= 0; c < bits_div; ++c, shft += size_t_bits )
+    size_t const n_lanes= ( n_bits + 63 ) / 64;      ///< #64 bit lanes
+    u64_t  h= seed ^ mum( seed ^ p0, p1 );
+    size_t i= 0;
+    // Four independent streams
+    if( n_lanes >= 8 )
     {
-      auto const crrnt= result_type( a >> shft );
-      do_combine( ret_val, crrnt, c );
+      u64_t  h1= h, h2= h ^ p2, h3= h ^ p3;
+      for( ; i + 8 <= n_lanes; i += 8 )
+      {
+        h=  mum( lane( arr, n_array, i   ) ^ p1, lane( arr, n_array, i+1 ) ^ h  );
+        h1= mum( lane( arr, n_array, i+2 ) ^ p2, lane( arr, n_array, i+3 ) ^ h1 );
+        h2= mum( lane( arr, n_array, i+4 ) ^ p3, lane( arr, n_array, i+5 ) ^ h2 );
+        h3= mum( lane( arr, n_array, i+6 ) ^ p0, lane( arr, n_array, i+7 ) ^ h3 );
+      }
+      h= mum( h ^ h2, h1 ^ h3 ^ p1 );
     }
-    return ret_val;
-  } // to_result_t
-
-  result_type
-  cmpsd_hash( array_t const & arr ) const noexcept
+    for( ; i + 2 <= n_lanes; i += 2 )
+      h= mum( lane( arr, n_array, i ) ^ p1, lane( arr, n_array, i+1 ) ^ h );
+    if( i < n_lanes ) h= mum( lane( arr, n_array, i ) ^ p1, h ^ p2 );
+    return mum( h ^ p0, u64_t( n_bits ) ^ p3 );
+  } // hash64
+
+  /// Multiplies a and b, folds the upper into the lower 64 bits
+  static
+  constexpr
+  u64_t
+  mum( u64_t a, u64_t b ) noexcept
   {
-    result_type ret_val= 0;
-
-    if( easy_ratio )
+#ifdef __SIZEOF_INT128__
+    auto const r= (unsigned __int128)a * b;
+    return u64_t( r ) ^ u64_t( r >> 64 );
+#else
+    u64_t const ha= a >> 32, hb= b >> 32;
+    u64_t const la= u64_t( uint32_t( a ) ), lb= u64_t( uint32_t( b ) );
+    u64_t const rh= ha * hb, rm0= ha * lb, rm1= hb * la, rl= la * lb;
+    u64_t const t=  rl + ( rm0 << 32 );
+    u64_t       c=  t < rl;
+    u64_t const lo= t + ( rm1 << 32 );
+    c += lo < t;
+    u64_t const hi= rh + ( rm0 >> 32 ) + ( rm1 >> 32 ) + c;
+    return lo ^ hi;
+#endif
+  } // mum
+
+  /// Bits [64i,64i+64) of arr
+  static
+  constexpr
+  u64_t
+  lane( T const *arr, size_t n_array, size_t i ) noexcept
+  {
+    if constexpr( base_t_n_bits >= 64 )
     {
-      for( size_t c= 0; c < n_words; c += size_t_div )
-      {
-        result_type  r= 0;
-        auto const uppr= std::min( n_words, c + size_t_div );
-        for( size_t w= c; w < uppr; ++w )
-             r |= ( result_type(arr[w]) << ((w-c)*base_t_n_bits) );
-        do_combine( ret_val, r, c / size_t_div );
-      }
+      (void)n_array;
+      return u64_t( arr[i * 64 / base_t_n_bits] >> ( i * 64 % base_t_n_bits ) );
     }
     else
     {
-      for( size_t c= 0; c < n_words; ++c )
-      {
-        auto const crrnt= easy_bits
-                          ? result_type(arr[c]) : to_result_t(arr[c]);
-        do_combine( ret_val, crrnt, c );
-      }
+      constexpr size_t per_lane= 64 / base_t_n_bits;
+      u64_t ret_val= 0;
+      for( size_t c= 0; c < per_lane && i * per_lane + c < n_array; ++c )
+        ret_val |= u64_t( arr[i * per_lane + c] ) << ( c * base_t_n_bits );
+      return ret_val;
     }
+  } // lane
+}; // struct hash_words
 
-    return ret_val;
-  } // cmpsd_hash
 
-  void
-  do_combine( result_type &r, result_type crrnt, size_t cnt ) const noexcept
-  {
-    crrnt += cnt;
-    auto const n_rot= cnt % size_t_bits;
-    if( n_rot > 0 )
-              crrnt= ( crrnt << n_rot ) | ( crrnt >> (size_t_bits-n_rot) );
+/// \brief Hash of the bits of a bitset2<N,T>, see hash_words.
+/// At runtime large arrays are hashed by the shared kernel for T.
+template<size_t N,class T>
+struct hash_impl
+{
+  using    base_t=        T;
+  using    result_type=   std::size_t;
+  using    u64_t=         uint64_t;
 
-    r ^= crrnt;
-  } // do_combine
+  enum : size_t
+  { n_array=        bit_chars<N,T>::n_array
+  };
+  enum : base_t
+  { hgh_bit_pattern= bit_chars<N,T>::hgh_bit_pattern
+  };
+
+  using    array_t=       typename h_types<T>::template array_t<n_array>;
+
+  /// Hash of arr, which is of type std::hash<bitset2<N,T>>::result_type
+  result_type
+  operator()( array_t const & arr ) const noexcept
+  { return result_type( hash64( arr, 0 ) ); }
+
+  /// 64 bit hash of arr, depending on seed
+  static
+  constexpr
+  u64_t
+  hash64( array_t const & arr, u64_t seed ) noexcept
+  {
+    return   use_shared_kernels<n_array,T>()
+           ? shared_kernels<T>::hash64( arr.data(), n_array,
+                                        hgh_bit_pattern, seed )
+           : hash_words<T>::hash64( arr.data(), n_array, N, seed );
+  }
 }; // struct hash_impl
 
 
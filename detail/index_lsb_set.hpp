@@ -31,6 +31,12 @@
 # define CMPLRCOUNTR 0
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+# define CMPLRBUILTIN 1
+#else
+# define CMPLRBUILTIN 0
+#endif
+
 
 
 namespace Bitset2
@@ -80,15 +86,30 @@ struct index_lsb_set
   constexpr
   size_t
   impl2( T val ) const noexcept
-  { 
-# ifdef __SIZEOF_INT128__
-    if constexpr( std::is_same_v<T,unsigned __int128> ) return impl(val);
-    else
-# endif
-    return std::countr_zero(val);
+  { return std::countr_zero(val); }
+#endif
+
+#ifdef __SIZEOF_INT128__
+  /// unsigned __int128: Use the 64 bit instructions on both halves
+  constexpr
+  size_t
+  impl_halves( T val ) const noexcept
+  {
+    using ull_t= unsigned long long;
+    auto const lo= ull_t( val );
+    return   lo != 0 ? index_lsb_set<ull_t>()( lo )
+           : 64 + index_lsb_set<ull_t>()( ull_t( val >> 64 ) );
   }
 #endif
 
+#if CMPLRBUILTIN
+  /// Constant folded by GCC and Clang, hence usable in C++17 constexpr
+  constexpr
+  size_t
+  impl3( T val ) const noexcept
+  { return size_t( __builtin_ctzll( (unsigned long long)val ) ); }
+#endif
+
   /// \brief Returns index of first (least significant) bit set in val.
   /// Returns npos if all bits are zero.
   constexpr
@@ -96,8 +117,17 @@ struct index_lsb_set
   operator()( T val ) const noexcept
   {
     if( T(0) == val ) return npos;
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+                                               return impl_halves(val);
+    else
+#endif
     if constexpr( CMPLRCOUNTR ) return impl2(val);
-    return impl(val);
+#if CMPLRBUILTIN
+    else if constexpr( n_bits <= sizeof(unsigned long long) * CHAR_BIT )
+                                               return impl3(val);
+#endif
+    else return impl(val);
   }
 }; // struct index_lsb_set
 
@@ -108,5 +138,6 @@ struct index_lsb_set
 
 
 #undef CMPLRCOUNTR
+#undef CMPLRBUILTIN
 
 #endif // BITSET2_INDEX_LSB_SET_CB_HPP
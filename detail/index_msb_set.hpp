@@ -31,6 +31,12 @@
 # define CMPLRCOUNTR 0
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+# define CMPLRBUILTIN 1
+#else
+# define CMPLRBUILTIN 0
+#endif
+
 
 
 namespace Bitset2
@@ -83,12 +89,30 @@ struct index_msb_set
   constexpr
   size_t
   impl2( T val ) const noexcept
-  { 
-# ifdef __SIZEOF_INT128__
-    if constexpr( std::is_same_v<T,unsigned __int128> ) return impl(val);
-    else
-# endif
-    return n_bits - 1 - std::countl_zero(val);
+  { return n_bits - 1 - std::countl_zero(val); }
+#endif
+
+#ifdef __SIZEOF_INT128__
+  /// unsigned __int128: Use the 64 bit instructions on both halves
+  constexpr
+  size_t
+  impl_halves( T val ) const noexcept
+  {
+    using ull_t= unsigned long long;
+    auto const hi= ull_t( val >> 64 );
+    return   hi != 0 ? 64 + index_msb_set<ull_t>()( hi )
+           : index_msb_set<ull_t>()( ull_t( val ) );
+  }
+#endif
+
+#if CMPLRBUILTIN
+  /// Constant folded by GCC and Clang, hence usable in C++17 constexpr
+  constexpr
+  size_t
+  impl3( T val ) const noexcept
+  {
+    return   sizeof(unsigned long long) * CHAR_BIT - 1
+           - size_t( __builtin_clzll( (unsigned long long)val ) );
   }
 #endif
 
@@ -99,8 +123,17 @@ struct index_msb_set
   operator()( T val ) const noexcept
   {
     if( T(0) == val ) return npos;
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+                                               return impl_halves(val);
+    else
+#endif
     if constexpr( CMPLRCOUNTR ) return impl2(val);
-    return impl(val);
+#if CMPLRBUILTIN
+    else if constexpr( n_bits <= sizeof(unsigned long long) * CHAR_BIT )
+                                               return impl3(val);
+#endif
+    else return impl(val);
   }
 }; // struct index_msb_set
 
@@ -111,6 +144,7 @@ struct index_msb_set
 
 
 #undef CMPLRCOUNTR
+#undef CMPLRBUILTIN
 
 
 #endif // BITSET2_INDEX_MSB_SET_CB_HPP
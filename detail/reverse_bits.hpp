@@ -16,6 +16,7 @@
 #include <limits>
 #include <climits>
 #include <cstddef>
+#include <type_traits>
 
 
 
@@ -42,7 +43,21 @@ struct reverse_bits
   /// \brief Reverses bits in val.
   constexpr
   T
-  operator()( T val ) const noexcept  { return rvrs( val ); }
+  operator()( T val ) const noexcept
+  {
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+    {
+      // Reverse both 64 bit halves and swap them
+      using ull_t= unsigned long long;
+      reverse_bits<ull_t> const  rb;
+      return   ( T( rb( ull_t( val ) ) ) << 64 )
+             |   T( rb( ull_t( val >> 64 ) ) );
+    }
+    else
+#endif
+    return rvrs( val );
+  }
 
 private:
   constexpr
@@ -0,0 +1,112 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_SELECT_BIT_SET_CB_HPP
+#define BITSET2_SELECT_BIT_SET_CB_HPP
+
+
+#include "h_types.hpp"
+#include "count_bits.hpp"
+#include "index_lsb_set.hpp"
+#include <limits>
+#include <climits>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__BMI2__) && ( defined(__GNUC__) || defined(__clang__) )
+# include <immintrin.h>
+# define CMPLRPDEP
+#endif
+
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+
+/// Finds the k-th (counting from zero) least significant bit set in a word
+template<class T>
+struct select_bit_set
+{
+  enum : size_t { npos=   std::numeric_limits<size_t>::max()
+                , n_bits= sizeof(T) * CHAR_BIT };
+
+  /// Clears the k lowest bits set
+  constexpr
+  size_t
+  impl( T val, size_t k ) const noexcept
+  {
+    for( ; k > 0 && val != T(0); --k ) val &= T( val - 1 );
+    return index_lsb_set<T>()( val );
+  } // impl
+
+#ifdef __SIZEOF_INT128__
+  /// unsigned __int128: Select in the half containing the bit
+  constexpr
+  size_t
+  impl_halves( T val, size_t k ) const noexcept
+  {
+    using ull_t= unsigned long long;
+    auto const lo=    ull_t( val );
+    auto const n_lo=  count_bits( lo );
+    if( k < n_lo ) return select_bit_set<ull_t>()( lo, k );
+    auto const idx= select_bit_set<ull_t>()( ull_t( val >> 64 ), k - n_lo );
+    return idx == npos ? npos : 64 + idx;
+  }
+#endif
+
+#ifdef CMPLRPDEP
+  /// Deposits bit k at the k-th bit set in val
+  size_t
+  impl_pdep( T val, size_t k ) const noexcept
+  {
+    auto const dep= _pdep_u64( 1ull << k, (unsigned long long)val );
+    return dep == 0 ? npos : size_t( _tzcnt_u64( dep ) );
+  }
+#endif
+
+  /// \brief Returns index of k-th (counting from zero) least significant
+  /// bit set in val. Returns npos if less than k+1 bits are set.
+  constexpr
+  size_t
+  operator()( T val, size_t k ) const noexcept
+  {
+    if( k >= n_bits ) return npos;
+#ifdef __SIZEOF_INT128__
+    if constexpr( std::is_same_v<T,unsigned __int128> )
+                                           return impl_halves( val, k );
+    else
+#endif
+#ifdef CMPLRPDEP
+    if constexpr( n_bits <= 64 )
+    {
+      if( !ce_is_constant_evaluated() ) return impl_pdep( val, k );
+      return impl( val, k );
+    }
+    else
+#endif
+    return impl( val, k );
+  }
+}; // struct select_bit_set
+
+
+
+} // namespace detail
+} // namespace Bitset2
+
+
+#undef CMPLRPDEP
+
+#endif // BITSET2_SELECT_BIT_SET_CB_HPP
@@ -0,0 +1,214 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_SET_BITS_VIEW_CB_HPP
+#define BITSET2_SET_BITS_VIEW_CB_HPP
+
+
+#include "h_types.hpp"
+#include "index_lsb_set.hpp"
+#include "index_msb_set.hpp"
+#include <iterator>
+#include <cstddef>
+
+#if __cplusplus > 201703L && defined(__cpp_lib_ranges)
+# include <ranges>
+# define BITSET2_RANGES
+#endif
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+
+/// \brief Forward iterator over the indices of the set bits in an array.
+/// If rev==false indices are visited in ascending order,
+/// otherwise in descending order.
+/// The current word is kept and the visited bit gets cleared in each step.
+template<size_t n_array,class T,bool rev>
+class set_bits_iterator
+{
+  using base_t=   T;
+  using array_t=  typename h_types<T>::template array_t<n_array>;
+
+  enum : size_t { base_t_n_bits= h_types<T>::base_t_n_bits };
+
+public:
+  using value_type=        size_t;
+  using difference_type=   std::ptrdiff_t;
+  using reference=         size_t;
+  using pointer=           void;
+  using iterator_category= std::input_iterator_tag;
+  using iterator_concept=  std::forward_iterator_tag;
+
+  constexpr
+  set_bits_iterator() noexcept= default;
+
+  /// Iterator pointing to first set bit in arr. Pass at_end=true for end().
+  constexpr
+  set_bits_iterator( array_t const &arr, bool at_end ) noexcept
+  : m_arr( &arr )
+  , m_idx( ( at_end != rev ) ? n_array : 0 )
+  {
+    if( at_end ) return;
+    if( rev )
+    {
+      m_idx= n_array;
+      m_word= n_array > 0 ? arr[n_array-1] : base_t(0);
+    }
+    else m_word= n_array > 0 ? arr[0] : base_t(0);
+    if( m_word == base_t(0) ) next_word();
+    else                      set_bit();
+  }
+
+  /// Index of the current bit
+  constexpr
+  size_t
+  operator*() const noexcept
+  {
+    return rev ? ( m_idx - 1 ) * base_t_n_bits + m_bit
+               : m_idx * base_t_n_bits + index_lsb_set<T>()( m_word );
+  }
+
+  constexpr
+  set_bits_iterator &
+  operator++() noexcept
+  {
+    if( rev ) m_word ^= T( T(1) << m_bit );
+    else      m_word &= T( m_word - 1 );
+    if( m_word == base_t(0) ) next_word();
+    else                      set_bit();
+    return *this;
+  }
+
+  constexpr
+  set_bits_iterator
+  operator++(int) noexcept
+  {
+    set_bits_iterator tmp( *this );
+    operator++();
+    return tmp;
+  }
+
+  friend
+  constexpr
+  bool
+  operator==( set_bits_iterator const &it1,
+              set_bits_iterator const &it2 ) noexcept
+  { return it1.m_idx == it2.m_idx && it1.m_word == it2.m_word; }
+
+  friend
+  constexpr
+  bool
+  operator!=( set_bits_iterator const &it1,
+              set_bits_iterator const &it2 ) noexcept
+  { return !( it1 == it2 ); }
+
+private:
+  /// Moves to next word not equal to zero, or to the end.
+  constexpr
+  void
+  next_word() noexcept
+  {
+    if( rev )
+    {
+      while( m_idx > 0 )
+      {
+        --m_idx;
+        if( m_idx == 0 ) break;
+        m_word= (*m_arr)[m_idx-1];
+        if( m_word != base_t(0) ) { set_bit(); return; }
+      }
+      m_word= base_t(0);
+    }
+    else
+    {
+      while( ++m_idx < n_array )
+      {
+        m_word= (*m_arr)[m_idx];
+        if( m_word != base_t(0) ) return;
+      }
+      m_idx=  n_array;
+      m_word= base_t(0);
+    }
+  } // next_word
+
+  /// Caches index of the most significant bit, needed for rev==true only
+  constexpr
+  void
+  set_bit() noexcept
+  { if( rev ) m_bit= index_msb_set<T>()( m_word ); }
+
+  array_t const  *m_arr= nullptr;
+  size_t         m_idx=  0;   ///< Word index, plus one if rev==true
+  base_t         m_word= base_t(0);
+  size_t         m_bit=  0;
+}; // class set_bits_iterator
+
+
+
+/// \brief Range of the indices of the set bits in an array.
+/// Refers to the array, which needs to outlive the view.
+template<size_t n_array,class T,bool rev>
+class set_bits_view
+#ifdef BITSET2_RANGES
+: public std::ranges::view_interface<set_bits_view<n_array,T,rev> >
+#endif
+{
+  using array_t=  typename h_types<T>::template array_t<n_array>;
+
+public:
+  using iterator=       set_bits_iterator<n_array,T,rev>;
+  using const_iterator= iterator;
+
+  constexpr
+  set_bits_view() noexcept= default;
+
+  explicit
+  constexpr
+  set_bits_view( array_t const &arr ) noexcept
+  : m_arr( &arr )
+  {}
+
+  constexpr
+  iterator
+  begin() const noexcept
+  { return m_arr ? iterator( *m_arr, false ) : iterator(); }
+
+  constexpr
+  iterator
+  end() const noexcept
+  { return m_arr ? iterator( *m_arr, true ) : iterator(); }
+
+private:
+  array_t const  *m_arr= nullptr;
+}; // class set_bits_view
+
+
+} // namespace detail
+} // namespace Bitset2
+
+
+#ifdef BITSET2_RANGES
+template<size_t n_array,class T,bool rev>
+inline constexpr bool
+std::ranges::enable_borrowed_range<Bitset2::detail::set_bits_view<n_array,T,rev> >
+  = true;
+#endif
+
+#undef BITSET2_RANGES
+
+
+#endif // BITSET2_SET_BITS_VIEW_CB_HPP
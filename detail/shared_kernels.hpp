@@ -0,0 +1,247 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+#ifndef BITSET2_SHARED_KERNELS_CB_HPP
+#define BITSET2_SHARED_KERNELS_CB_HPP
+
+
+#include "word_funcs.hpp"
+#include "count_bits.hpp"
+#include <cstdint>
+
+#if defined(__GNUC__) || defined(__clang__)
+# define CMPLRNOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+# define CMPLRNOINLINE __declspec(noinline)
+#else
+# define CMPLRNOINLINE
+#endif
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+  /// \brief Minimum size of an array (in bytes) for bitset2 to call the
+  /// shared kernels at runtime. Below, the inlined word loops are shorter
+  /// than a call.
+  enum : size_t { rt_shared_min_bytes= 32 };
+
+  /// \brief Minimum size (in bytes) for calling the shared kernels of the
+  /// streaming operations (bitwise ops, none, count, equal). Below,
+  /// compilers unroll the inlined SIMD loops completely, which is
+  /// faster than a call.
+  enum : size_t { rt_shared_stream_min_bytes= 1024 };
+
+  /// \brief Returns true if bitset2 should call shared_kernels<T> instead
+  /// of inlining the word loops for its n_array words. This is never
+  /// the case during constant evaluation or if BITSET2_NO_SHARED_KERNELS
+  /// is defined.
+  template<size_t n_array,class T,size_t min_bytes= rt_shared_min_bytes>
+  constexpr
+  bool
+  use_shared_kernels() noexcept
+  {
+#ifdef BITSET2_NO_SHARED_KERNELS
+    return false;
+#else
+    return n_array * sizeof(T) >= min_bytes
+           && !ce_is_constant_evaluated();
+#endif
+  }
+
+
+  template<class T> struct hash_words;
+
+
+  /// \brief Out-of-line versions of the algorithms in word_funcs<T>.
+  /// They depend on the number of words and the mask of the most
+  /// significant word (tail_mask) at runtime only. Thus all bitset2<N,T>
+  /// with the same T share a single copy, instead of each N inlining
+  /// its own word loops and SIMD kernels.
+  template<class T>
+  struct shared_kernels
+  {
+    using base_t=   T;
+    using w_funcs=  word_funcs<T>;
+    using op_type=  bitwise_op_type;
+
+    enum : size_t { base_t_n_bits= h_types<T>::base_t_n_bits };
+
+    /// \brief Algorithms for n_words words, the most significant one
+    /// masked by tail_mask, which must consist of the lowest bits
+    static
+    constexpr
+    w_funcs
+    wf( size_t n_words, base_t tail_mask ) noexcept
+    {
+      return w_funcs( n_words == 0 ? 0
+                      : ( n_words - 1 ) * base_t_n_bits + count_bits( tail_mask ),
+                      n_words );
+    }
+
+    CMPLRNOINLINE static
+    void
+    bitwise_op( T *dst, size_t n_words, base_t tail_mask,
+                op_type opt, T const *arr1, T const *arr2 ) noexcept
+    { wf( n_words, tail_mask ).bitwise_op( opt, dst, arr1, arr2 ); }
+
+    CMPLRNOINLINE static
+    bool
+    none( T const *arr, size_t n_words, base_t tail_mask ) noexcept
+    { return wf( n_words, tail_mask ).none( arr ); }
+
+    CMPLRNOINLINE static
+    bool
+    all( T const *arr, size_t n_words, base_t tail_mask ) noexcept
+    { return wf( n_words, tail_mask ).all( arr ); }
+
+    CMPLRNOINLINE static
+    size_t
+    count( T const *arr, size_t n_words, base_t tail_mask ) noexcept
+    { return wf( n_words, tail_mask ).count( arr ); }
+
+    CMPLRNOINLINE static
+    size_t
+    count_op( T const *arr1, size_t n_words, base_t tail_mask,
+              op_type opt, T const *arr2 ) noexcept
+    { return wf( n_words, tail_mask ).count_op( opt, arr1, arr2 ); }
+
+    CMPLRNOINLINE static
+    size_t
+    rank( T const *arr, size_t n_words, base_t tail_mask, size_t idx ) noexcept
+    { return wf( n_words, tail_mask ).rank( arr, idx ); }
+
+    CMPLRNOINLINE static
+    size_t
+    select( T const *arr, size_t n_words, base_t tail_mask, size_t k ) noexcept
+    { return wf( n_words, tail_mask ).select( arr, k ); }
+
+    template<class IdxT>
+    CMPLRNOINLINE static
+    size_t
+    decode_positions( T const *arr, size_t n_words, base_t tail_mask,
+                      IdxT *out, size_t max_n ) noexcept
+    { return wf( n_words, tail_mask ).decode_positions( arr, out, max_n ); }
+
+    CMPLRNOINLINE static
+    bool
+    has_single_bit( T const *arr, size_t n_words, base_t tail_mask ) noexcept
+    { return wf( n_words, tail_mask ).has_single_bit( arr ); }
+
+    CMPLRNOINLINE static
+    bool
+    equal( T const *arr1, size_t n_words, base_t tail_mask,
+           T const *arr2 ) noexcept
+    { return wf( n_words, tail_mask ).equal( arr1, arr2 ); }
+
+    CMPLRNOINLINE static
+    int
+    compare( T const *arr1, size_t n_words, base_t tail_mask,
+             T const *arr2 ) noexcept
+    { return wf( n_words, tail_mask ).compare( arr1, arr2 ); }
+
+    CMPLRNOINLINE static
+    size_t
+    idx_lsb_set( T const *arr, size_t n_words, base_t tail_mask,
+                 base_t v, size_t idx, base_t hgh_bit_pttrn ) noexcept
+    { return wf( n_words, tail_mask ).idx_lsb_set( arr, v, idx, hgh_bit_pttrn ); }
+
+    CMPLRNOINLINE static
+    size_t
+    idx_msb_set( T const *arr, size_t n_words, base_t tail_mask,
+                 base_t hgh_bit_pttrn ) noexcept
+    { return wf( n_words, tail_mask ).idx_msb_set( arr, hgh_bit_pttrn ); }
+
+    CMPLRNOINLINE static
+    void
+    flip_assgn( T *arr, size_t n_words, base_t tail_mask ) noexcept
+    { wf( n_words, tail_mask ).flip_assgn( arr ); }
+
+    CMPLRNOINLINE static
+    void
+    increment( T *arr, size_t n_words, base_t tail_mask ) noexcept
+    { wf( n_words, tail_mask ).increment( arr ); }
+
+    CMPLRNOINLINE static
+    void
+    decrement( T *arr, size_t n_words, base_t tail_mask ) noexcept
+    { wf( n_words, tail_mask ).decrement( arr ); }
+
+    CMPLRNOINLINE static
+    void
+    add_assgn( T *arr1, size_t n_words, base_t tail_mask,
+               T const *arr2, base_t carry ) noexcept
+    { wf( n_words, tail_mask ).add_assgn( arr1, arr2, carry ); }
+
+    CMPLRNOINLINE static
+    void
+    comp2_assgn( T *arr, size_t n_words, base_t tail_mask ) noexcept
+    { wf( n_words, tail_mask ).comp2_assgn( arr ); }
+
+    CMPLRNOINLINE static
+    void
+    shift_left_assgn( T *arr, size_t n_words, base_t tail_mask,
+                      size_t n_shift ) noexcept
+    { wf( n_words, tail_mask ).shift_left_assgn( arr, n_shift ); }
+
+    CMPLRNOINLINE static
+    void
+    shift_right_assgn( T *arr, size_t n_words, base_t tail_mask,
+                       size_t n_shift ) noexcept
+    { wf( n_words, tail_mask ).shift_right_assgn( arr, n_shift ); }
+
+    /// out must not alias arr
+    CMPLRNOINLINE static
+    void
+    rotate_left( T const *arr, size_t n_words, base_t tail_mask,
+                 T *out, size_t n_rot ) noexcept
+    { wf( n_words, tail_mask ).rotate_left( arr, out, n_rot ); }
+
+    /// out must not alias arr
+    CMPLRNOINLINE static
+    void
+    reverse( T const *arr, size_t n_words, base_t tail_mask, T *out ) noexcept
+    { wf( n_words, tail_mask ).reverse( arr, out ); }
+
+    CMPLRNOINLINE static
+    void
+    rotate_assgn( T *arr, size_t n_words, base_t tail_mask,
+                  size_t n_rot ) noexcept
+    { wf( n_words, tail_mask ).rotate_assgn( arr, n_rot ); }
+
+    CMPLRNOINLINE static
+    void
+    reverse_assgn( T *arr, size_t n_words, base_t tail_mask ) noexcept
+    { wf( n_words, tail_mask ).reverse_assgn( arr ); }
+
+    /// See hash_impl, the number of bits is derived from tail_mask
+    CMPLRNOINLINE static
+    uint64_t
+    hash64( T const *arr, size_t n_words, base_t tail_mask,
+            uint64_t seed ) noexcept
+    {
+      return hash_words<T>::hash64( arr, n_words,
+                                    wf( n_words, tail_mask ).n_bits(), seed );
+    }
+  }; // struct shared_kernels
+
+
+} // namespace detail
+} // namespace Bitset2
+
+
+#undef CMPLRNOINLINE
+
+
+#endif // BITSET2_SHARED_KERNELS_CB_HPP
@@ -0,0 +1,893 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+#ifndef BITSET2_SIMD_KERNELS_CB_HPP
+#define BITSET2_SIMD_KERNELS_CB_HPP
+
+
+#include "h_types.hpp"
+#include "index_lsb_set.hpp"
+#include "index_msb_set.hpp"
+#include "reverse_bits.hpp"
+#include <cstring>
+#include <cstdint>
+
+#if !defined(BITSET2_NO_SIMD) && \
+    ( defined(__SSE2__) || defined(__AVX2__) || defined(__AVX512F__) )
+# include <immintrin.h>
+# ifdef __AVX512F__
+#  define BITSET2_SIMD512
+# endif
+# if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+#  define BITSET2_POPCNT512
+# endif
+# ifdef __AVX2__
+#  define BITSET2_SIMD256
+# endif
+# ifdef __SSSE3__
+#  define BITSET2_SSSE3
+# endif
+# define BITSET2_SIMD128
+#endif
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+  /// \brief Returns true if the runtime kernels below should be used
+  /// instead of the constexpr word loops. This is never the case during
+  /// constant evaluation or if BITSET2_NO_SIMD is defined.
+  constexpr
+  bool
+  use_rt_kernels() noexcept
+  {
+#ifdef BITSET2_NO_SIMD
+    return false;
+#else
+    return !ce_is_constant_evaluated();
+#endif
+  }
+
+
+  /// Minimum size of an array (in bytes) for the runtime kernels to pay off
+  enum : size_t { rt_kernel_min_bytes= 16 };
+
+  /// \brief Minimum size (in bytes) for the popcount kernel to pay off.
+  /// With VPOPCNTDQ compilers vectorize the word loop on their own.
+#ifdef BITSET2_POPCNT512
+  enum : size_t { rt_popcount_min_bytes= 512 };
+#else
+  enum : size_t { rt_popcount_min_bytes= 64 };
+#endif
+
+  /// Minimum size (in bytes) for the fused bitwise op and popcount kernel
+  enum : size_t { rt_count_op_min_bytes= 64 };
+
+  /// Minimum size (in bytes) for the Harley-Seal popcount to pay off
+  enum : size_t { rt_harley_seal_min_bytes= 512 };
+
+  /// \brief Words with at most this many bits set are decoded bit by bit,
+  /// denser ones by compressing a vector of indices.
+  enum : size_t { rt_compress_min_bits= 8 };
+
+
+namespace rt_kernels
+{
+  /// \brief Word and vector operations for each bitwise_op_type.
+  /// Member w works on any unsigned integral, v on SIMD registers.
+  template<bitwise_op_type opt> struct op_traits;
+
+  template<>
+  struct op_traits<bitwise_op_type::or_op>
+  {
+    template<class U>
+    static U w( U a, U b ) noexcept { return U( a | b ); }
+#ifdef BITSET2_SIMD512
+    static __m512i v( __m512i a, __m512i b ) noexcept
+    { return _mm512_or_si512( a, b ); }
+#endif
+#ifdef BITSET2_SIMD256
+    static __m256i v( __m256i a, __m256i b ) noexcept
+    { return _mm256_or_si256( a, b ); }
+#endif
+#ifdef BITSET2_SIMD128
+    static __m128i v( __m128i a, __m128i b ) noexcept
+    { return _mm_or_si128( a, b ); }
+#endif
+  }; // struct op_traits<or_op>
+
+  template<>
+  struct op_traits<bitwise_op_type::and_op>
+  {
+    template<class U>
+    static U w( U a, U b ) noexcept { return U( a & b ); }
+#ifdef BITSET2_SIMD512
+    static __m512i v( __m512i a, __m512i b ) noexcept
+    { return _mm512_and_si512( a, b ); }
+#endif
+#ifdef BITSET2_SIMD256
+    static __m256i v( __m256i a, __m256i b ) noexcept
+    { return _mm256_and_si256( a, b ); }
+#endif
+#ifdef BITSET2_SIMD128
+    static __m128i v( __m128i a, __m128i b ) noexcept
+    { return _mm_and_si128( a, b ); }
+#endif
+  }; // struct op_traits<and_op>
+
+  template<>
+  struct op_traits<bitwise_op_type::xor_op>
+  {
+    template<class U>
+    static U w( U a, U b ) noexcept { return U( a ^ b ); }
+#ifdef BITSET2_SIMD512
+    static __m512i v( __m512i a, __m512i b ) noexcept
+    { return _mm512_xor_si512( a, b ); }
+#endif
+#ifdef BITSET2_SIMD256
+    static __m256i v( __m256i a, __m256i b ) noexcept
+    { return _mm256_xor_si256( a, b ); }
+#endif
+#ifdef BITSET2_SIMD128
+    static __m128i v( __m128i a, __m128i b ) noexcept
+    { return _mm_xor_si128( a, b ); }
+#endif
+  }; // struct op_traits<xor_op>
+
+  /// Set difference a & ~b. Note that andnot negates its first argument.
+  template<>
+  struct op_traits<bitwise_op_type::sdiff_op>
+  {
+    template<class U>
+    static U w( U a, U b ) noexcept { return U( a & U(~b) ); }
+#ifdef BITSET2_SIMD512
+    // maskz variant avoids a -Wmaybe-uninitialized false positive in GCC 12
+    static __m512i v( __m512i a, __m512i b ) noexcept
+    { return _mm512_maskz_andnot_epi64( __mmask8(0xFF), b, a ); }
+#endif
+#ifdef BITSET2_SIMD256
+    static __m256i v( __m256i a, __m256i b ) noexcept
+    { return _mm256_andnot_si256( b, a ); }
+#endif
+#ifdef BITSET2_SIMD128
+    static __m128i v( __m128i a, __m128i b ) noexcept
+    { return _mm_andnot_si128( b, a ); }
+#endif
+  }; // struct op_traits<sdiff_op>
+
+
+  // GCC 12 warns about the vector loads and stores if a bounded_bitset2
+  // holds a single word, although they are not reached then
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Warray-bounds"
+# pragma GCC diagnostic ignored "-Wstringop-overflow"
+#endif
+  /// \brief dst[i]= a[i] op b[i] for n_bytes bytes. dst may be equal to a
+  /// or b. The layout of the words does not matter for bitwise operations.
+  template<bitwise_op_type opt>
+  inline
+  void
+  zip_bytes( unsigned char *dst,
+             unsigned char const *a, unsigned char const *b,
+             size_t n_bytes ) noexcept
+  {
+    using op= op_traits<opt>;
+    size_t c= 0;
+#ifdef BITSET2_SIMD512
+    for( ; c + 64 <= n_bytes; c += 64 )
+      _mm512_storeu_si512( dst + c, op::v( _mm512_loadu_si512( a + c ),
+                                           _mm512_loadu_si512( b + c ) ) );
+#endif
+#ifdef BITSET2_SIMD256
+    for( ; c + 32 <= n_bytes; c += 32 )
+      _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>( dst + c ),
+        op::v( _mm256_loadu_si256( reinterpret_cast<__m256i const *>(a + c) ),
+               _mm256_loadu_si256( reinterpret_cast<__m256i const *>(b + c) )));
+#endif
+#ifdef BITSET2_SIMD128
+    for( ; c + 16 <= n_bytes; c += 16 )
+      _mm_storeu_si128(
+        reinterpret_cast<__m128i *>( dst + c ),
+        op::v( _mm_loadu_si128( reinterpret_cast<__m128i const *>( a + c ) ),
+               _mm_loadu_si128( reinterpret_cast<__m128i const *>( b + c ) )));
+#endif
+    for( ; c + 8 <= n_bytes; c += 8 )
+    {
+      uint64_t  v1, v2;
+      std::memcpy( &v1, a + c, 8 );
+      std::memcpy( &v2, b + c, 8 );
+      v1= op::w( v1, v2 );
+      std::memcpy( dst + c, &v1, 8 );
+    }
+    for( ; c < n_bytes; ++c ) dst[c]= op::w( a[c], b[c] );
+  } // zip_bytes
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic pop
+#endif
+
+
+  /// dst= a op b, where each argument points to n_bytes bytes.
+  inline
+  void
+  bitwise_op( bitwise_op_type opt,
+              void *dst, void const *a, void const *b,
+              size_t n_bytes ) noexcept
+  {
+    auto       d=  static_cast<unsigned char *>( dst );
+    auto const s1= static_cast<unsigned char const *>( a );
+    auto const s2= static_cast<unsigned char const *>( b );
+    switch( opt )
+    {
+      case bitwise_op_type::or_op:
+        zip_bytes<bitwise_op_type::or_op>(   d, s1, s2, n_bytes ); break;
+      case bitwise_op_type::and_op:
+        zip_bytes<bitwise_op_type::and_op>(  d, s1, s2, n_bytes ); break;
+      case bitwise_op_type::xor_op:
+        zip_bytes<bitwise_op_type::xor_op>(  d, s1, s2, n_bytes ); break;
+      default:
+        zip_bytes<bitwise_op_type::sdiff_op>( d, s1, s2, n_bytes ); break;
+    } // switch
+  } // bitwise_op
+
+
+  /// \brief dst= f( a, b, c ) for n_bytes bytes, where f is given by the
+  /// truth table imm (see ce_ternary). dst may be equal to a, b or c.
+  /// One vpternlogq per 64 bytes with AVX-512.
+  template<uint8_t imm>
+  inline
+  void
+  ternary_op( void *dst, void const *a, void const *b, void const *c,
+              size_t n_bytes ) noexcept
+  {
+    auto       d=  static_cast<unsigned char *>( dst );
+    auto const s1= static_cast<unsigned char const *>( a );
+    auto const s2= static_cast<unsigned char const *>( b );
+    auto const s3= static_cast<unsigned char const *>( c );
+    size_t i= 0;
+#ifdef BITSET2_SIMD512
+    for( ; i + 64 <= n_bytes; i += 64 )
+      _mm512_storeu_si512( d + i,
+                           _mm512_ternarylogic_epi64( _mm512_loadu_si512( s1 + i ),
+                                                      _mm512_loadu_si512( s2 + i ),
+                                                      _mm512_loadu_si512( s3 + i ),
+                                                      int(imm) ) );
+#endif
+    for( ; i + 8 <= n_bytes; i += 8 )
+    {
+      uint64_t  v1, v2, v3;
+      std::memcpy( &v1, s1 + i, 8 );
+      std::memcpy( &v2, s2 + i, 8 );
+      std::memcpy( &v3, s3 + i, 8 );
+      v1= ce_ternary<imm>( v1, v2, v3 );
+      std::memcpy( d + i, &v1, 8 );
+    }
+    for( ; i < n_bytes; ++i ) d[i]= ce_ternary<imm>( s1[i], s2[i], s3[i] );
+  } // ternary_op
+
+
+#ifdef BITSET2_SSSE3
+  /// \brief Reverses the bits in each byte of v by looking up both nibbles
+  /// (pshufb), then reverses the order of the bytes
+  inline
+  __m128i
+  reverse_bits128( __m128i v ) noexcept
+  {
+    using ll_t= long long;
+    __m128i const lo_tbl= _mm_set_epi64x( ll_t( 0xF070B030D0509010ull ),
+                                          ll_t( 0xE060A020C0408000ull ) );
+    __m128i const hi_tbl= _mm_set_epi64x( ll_t( 0x0F070B030D050901ull ),
+                                          ll_t( 0x0E060A020C040800ull ) );
+    __m128i const rv_idx= _mm_set_epi64x( ll_t( 0x0001020304050607ull ),
+                                          ll_t( 0x08090A0B0C0D0E0Full ) );
+    __m128i const m4=     _mm_set1_epi8( 0x0F );
+    auto const lo= _mm_and_si128( v, m4 );
+    auto const hi= _mm_and_si128( _mm_srli_epi16( v, 4 ), m4 );
+    return _mm_shuffle_epi8( _mm_or_si128( _mm_shuffle_epi8( lo_tbl, lo ),
+                                           _mm_shuffle_epi8( hi_tbl, hi ) ),
+                             rv_idx );
+  } // reverse_bits128
+#endif
+
+#ifdef BITSET2_SIMD256
+  /// See reverse_bits128, swaps the 128 bit lanes finally
+  inline
+  __m256i
+  reverse_bits256( __m256i v ) noexcept
+  {
+    using ll_t= long long;
+    __m256i const lo_tbl= _mm256_set_epi64x( ll_t( 0xF070B030D0509010ull ),
+                                             ll_t( 0xE060A020C0408000ull ),
+                                             ll_t( 0xF070B030D0509010ull ),
+                                             ll_t( 0xE060A020C0408000ull ) );
+    __m256i const hi_tbl= _mm256_set_epi64x( ll_t( 0x0F070B030D050901ull ),
+                                             ll_t( 0x0E060A020C040800ull ),
+                                             ll_t( 0x0F070B030D050901ull ),
+                                             ll_t( 0x0E060A020C040800ull ) );
+    __m256i const rv_idx= _mm256_set_epi64x( ll_t( 0x0001020304050607ull ),
+                                             ll_t( 0x08090A0B0C0D0E0Full ),
+                                             ll_t( 0x0001020304050607ull ),
+                                             ll_t( 0x08090A0B0C0D0E0Full ) );
+    __m256i const m4=     _mm256_set1_epi8( 0x0F );
+    auto const lo= _mm256_and_si256( v, m4 );
+    auto const hi= _mm256_and_si256( _mm256_srli_epi16( v, 4 ), m4 );
+    auto const r=
+      _mm256_shuffle_epi8( _mm256_or_si256( _mm256_shuffle_epi8( lo_tbl, lo ),
+                                            _mm256_shuffle_epi8( hi_tbl, hi ) ),
+                           rv_idx );
+    return _mm256_permute4x64_epi64( r, 0x4E );
+  } // reverse_bits256
+#endif
+
+
+  /// \brief Reverses the order of all bits in the n_bytes bytes at p in
+  /// place, i.e. the order of the bytes and the bits in each byte. Blocks
+  /// from both ends are reversed and swapped.
+  inline
+  void
+  reverse_all_bits( void *p, size_t n_bytes ) noexcept
+  {
+    auto   d=  static_cast<unsigned char *>( p );
+    size_t lo= 0;
+    size_t hi= n_bytes;
+#ifdef BITSET2_SIMD256
+    for( ; lo + 64 <= hi; lo += 32, hi -= 32 )
+    {
+      auto const pl= reinterpret_cast<__m256i *>( d + lo );
+      auto const ph= reinterpret_cast<__m256i *>( d + hi - 32 );
+      auto const vl= _mm256_loadu_si256( pl );
+      auto const vh= _mm256_loadu_si256( ph );
+      _mm256_storeu_si256( pl, reverse_bits256( vh ) );
+      _mm256_storeu_si256( ph, reverse_bits256( vl ) );
+    }
+#endif
+#ifdef BITSET2_SSSE3
+    for( ; lo + 32 <= hi; lo += 16, hi -= 16 )
+    {
+      auto const pl= reinterpret_cast<__m128i *>( d + lo );
+      auto const ph= reinterpret_cast<__m128i *>( d + hi - 16 );
+      auto const vl= _mm_loadu_si128( pl );
+      auto const vh= _mm_loadu_si128( ph );
+      _mm_storeu_si128( pl, reverse_bits128( vh ) );
+      _mm_storeu_si128( ph, reverse_bits128( vl ) );
+    }
+#endif
+    reverse_bits<uint64_t> const      rb64;
+    reverse_bits<unsigned char> const rb8;
+    for( ; lo + 16 <= hi; lo += 8, hi -= 8 )
+    {
+      uint64_t  vl, vh;
+      std::memcpy( &vl, d + lo, 8 );
+      std::memcpy( &vh, d + hi - 8, 8 );
+      vl= rb64( vl );
+      vh= rb64( vh );
+      std::memcpy( d + lo, &vh, 8 );
+      std::memcpy( d + hi - 8, &vl, 8 );
+    }
+    for( ; lo + 2 <= hi; ++lo, --hi )
+    {
+      auto const v= d[lo];
+      d[lo]=   rb8( d[hi-1] );
+      d[hi-1]= rb8( v );
+    }
+    if( lo < hi ) d[lo]= rb8( d[lo] );
+  } // reverse_all_bits
+
+
+
+  /// Number of bits set in a 64 bit word
+  inline
+  size_t
+  popcount64( uint64_t v ) noexcept
+  {
+#if defined(__GNUC__) || defined(__clang__)
+    return size_t( __builtin_popcountll( v ) );
+#else
+    v= v - ( ( v >> 1 ) & 0x5555555555555555ull );
+    v= ( v & 0x3333333333333333ull ) + ( ( v >> 2 ) & 0x3333333333333333ull );
+    v= ( v + ( v >> 4 ) ) & 0x0F0F0F0F0F0F0F0Full;
+    return size_t( ( v * 0x0101010101010101ull ) >> 56 );
+#endif
+  } // popcount64
+
+
+  /// Reads n_bytes bytes at p, used by popcount
+  struct single_src
+  {
+    unsigned char const *p;
+
+#ifdef BITSET2_SIMD512
+    __m512i v512( size_t c ) const noexcept
+    { return _mm512_loadu_si512( p + c ); }
+#endif
+#ifdef BITSET2_SIMD256
+    __m256i v256( size_t c ) const noexcept
+    { return _mm256_loadu_si256( reinterpret_cast<__m256i const *>(p + c) ); }
+#endif
+    uint64_t w( size_t c ) const noexcept
+    {
+      uint64_t v;
+      std::memcpy( &v, p + c, 8 );
+      return v;
+    }
+    unsigned char byte( size_t c ) const noexcept { return p[c]; }
+  }; // struct single_src
+
+
+  /// \brief Combines the bytes at a and b by opt while reading,
+  /// used by popcount_op
+  template<bitwise_op_type opt>
+  struct zip_src
+  {
+    using op= op_traits<opt>;
+
+    unsigned char const *a;
+    unsigned char const *b;
+
+#ifdef BITSET2_SIMD512
+    __m512i v512( size_t c ) const noexcept
+    { return op::v( _mm512_loadu_si512( a + c ), _mm512_loadu_si512( b + c ) ); }
+#endif
+#ifdef BITSET2_SIMD256
+    __m256i v256( size_t c ) const noexcept
+    {
+      return
+        op::v( _mm256_loadu_si256( reinterpret_cast<__m256i const *>(a + c) ),
+               _mm256_loadu_si256( reinterpret_cast<__m256i const *>(b + c) ));
+    }
+#endif
+    uint64_t w( size_t c ) const noexcept
+    {
+      uint64_t  v1, v2;
+      std::memcpy( &v1, a + c, 8 );
+      std::memcpy( &v2, b + c, 8 );
+      return op::w( v1, v2 );
+    }
+    unsigned char byte( size_t c ) const noexcept
+    { return op::w( a[c], b[c] ); }
+  }; // struct zip_src
+
+
+#ifdef BITSET2_SIMD256
+  /// Per 64 bit lane bit counts of v, using a nibble lookup table
+  inline
+  __m256i
+  popcount256( __m256i v ) noexcept
+  {
+    __m256i const lookup=
+      _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+    __m256i const low_mask= _mm256_set1_epi8( 0x0F );
+    __m256i const lo=  _mm256_and_si256( v, low_mask );
+    __m256i const hi=  _mm256_and_si256( _mm256_srli_epi16( v, 4 ), low_mask );
+    __m256i const cnt= _mm256_add_epi8( _mm256_shuffle_epi8( lookup, lo ),
+                                        _mm256_shuffle_epi8( lookup, hi ) );
+    return _mm256_sad_epu8( cnt, _mm256_setzero_si256() );
+  } // popcount256
+
+  /// Carry save adder: h:l= a + b + c
+  inline
+  void
+  csa256( __m256i &h, __m256i &l, __m256i a, __m256i b, __m256i c ) noexcept
+  {
+    __m256i const u= _mm256_xor_si256( a, b );
+    h= _mm256_or_si256( _mm256_and_si256( a, b ), _mm256_and_si256( u, c ) );
+    l= _mm256_xor_si256( u, c );
+  } // csa256
+
+  inline
+  __m256i
+  load256( unsigned char const *p, size_t idx ) noexcept
+  { return _mm256_loadu_si256( reinterpret_cast<__m256i const *>(p) + idx ); }
+
+  /// Sum of the four 64 bit lanes in v
+  inline
+  size_t
+  sum_lanes( __m256i v ) noexcept
+  {
+    return size_t(   uint64_t( _mm256_extract_epi64( v, 0 ) )
+                   + uint64_t( _mm256_extract_epi64( v, 1 ) )
+                   + uint64_t( _mm256_extract_epi64( v, 2 ) )
+                   + uint64_t( _mm256_extract_epi64( v, 3 ) ) );
+  }
+
+  /// \brief Harley-Seal popcount of n_vec 256 bit vectors, see
+  /// W. Mula, N. Kurz, D. Lemire: Faster Population Counts Using AVX2
+  /// Instructions, https://arxiv.org/abs/1611.07612
+  template<class Src>
+  inline
+  size_t
+  popcount_harley_seal( Src const &src, size_t n_vec ) noexcept
+  {
+    __m256i total=    _mm256_setzero_si256();
+    __m256i ones=     _mm256_setzero_si256();
+    __m256i twos=     _mm256_setzero_si256();
+    __m256i fours=    _mm256_setzero_si256();
+    __m256i eights=   _mm256_setzero_si256();
+    __m256i sixteens, twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+
+    size_t i= 0;
+    for( ; i + 16 <= n_vec; i += 16 )
+    {
+      csa256( twos_a,   ones,   ones,   src.v256( 32*(i+0) ),  src.v256( 32*(i+1) ) );
+      csa256( twos_b,   ones,   ones,   src.v256( 32*(i+2) ),  src.v256( 32*(i+3) ) );
+      csa256( fours_a,  twos,   twos,   twos_a,             twos_b );
+      csa256( twos_a,   ones,   ones,   src.v256( 32*(i+4) ),  src.v256( 32*(i+5) ) );
+      csa256( twos_b,   ones,   ones,   src.v256( 32*(i+6) ),  src.v256( 32*(i+7) ) );
+      csa256( fours_b,  twos,   twos,   twos_a,             twos_b );
+      csa256( eights_a, fours,  fours,  fours_a,            fours_b );
+      csa256( twos_a,   ones,   ones,   src.v256( 32*(i+8) ),  src.v256( 32*(i+9) ) );
+      csa256( twos_b,   ones,   ones,   src.v256( 32*(i+10) ), src.v256( 32*(i+11) ));
+      csa256( fours_a,  twos,   twos,   twos_a,             twos_b );
+      csa256( twos_a,   ones,   ones,   src.v256( 32*(i+12) ), src.v256( 32*(i+13) ));
+      csa256( twos_b,   ones,   ones,   src.v256( 32*(i+14) ), src.v256( 32*(i+15) ));
+      csa256( fours_b,  twos,   twos,   twos_a,             twos_b );
+      csa256( eights_b, fours,  fours,  fours_a,            fours_b );
+      csa256( sixteens, eights, eights, eights_a,           eights_b );
+      total= _mm256_add_epi64( total, popcount256( sixteens ) );
+    } // for i
+
+    total= _mm256_slli_epi64( total, 4 );
+    total= _mm256_add_epi64( total,
+                             _mm256_slli_epi64( popcount256( eights ), 3 ) );
+    total= _mm256_add_epi64( total,
+                             _mm256_slli_epi64( popcount256( fours ), 2 ) );
+    total= _mm256_add_epi64( total,
+                             _mm256_slli_epi64( popcount256( twos ), 1 ) );
+    total= _mm256_add_epi64( total, popcount256( ones ) );
+    for( ; i < n_vec; ++i )
+           total= _mm256_add_epi64( total, popcount256( src.v256( 32*i ) ) );
+
+    return sum_lanes( total );
+  } // popcount_harley_seal
+#endif // BITSET2_SIMD256
+
+
+  /// Number of bits set in n_bytes bytes read from src
+  template<class Src>
+  inline
+  size_t
+  popcount_src( Src const &src, size_t n_bytes ) noexcept
+  {
+    size_t     c= 0;
+    size_t     ct= 0;
+#if defined(BITSET2_POPCNT512)
+    if( n_bytes >= 64 )
+    {
+      __m512i  acc=  _mm512_setzero_si512();
+      __m512i  acc2= _mm512_setzero_si512();
+      for( ; c + 128 <= n_bytes; c += 128 )
+      {
+        acc=  _mm512_add_epi64( acc,  _mm512_popcnt_epi64( src.v512( c ) ) );
+        acc2= _mm512_add_epi64( acc2, _mm512_popcnt_epi64( src.v512( c+64 ) ));
+      }
+      for( ; c + 64 <= n_bytes; c += 64 )
+        acc= _mm512_add_epi64( acc, _mm512_popcnt_epi64( src.v512( c ) ) );
+      acc= _mm512_add_epi64( acc, acc2 );
+      // Unmasked extracts and _mm512_reduce_add_epi64 upset GCC 12 warnings
+      ct= sum_lanes( _mm256_add_epi64(
+                         _mm512_maskz_extracti64x4_epi64( 0xFF, acc, 0 ),
+                         _mm512_maskz_extracti64x4_epi64( 0xFF, acc, 1 ) ) );
+    }
+#elif defined(BITSET2_SIMD256)
+    if( n_bytes >= rt_harley_seal_min_bytes )
+    {
+      ct= popcount_harley_seal( src, n_bytes / 32 );
+      c=  n_bytes - n_bytes % 32;
+    }
+    else if( n_bytes >= 32 )
+    {
+      __m256i acc= _mm256_setzero_si256();
+      for( ; c + 32 <= n_bytes; c += 32 )
+                   acc= _mm256_add_epi64( acc, popcount256( src.v256( c ) ) );
+      ct= sum_lanes( acc );
+    }
+#endif
+    for( ; c + 8 <= n_bytes; c += 8 ) ct += popcount64( src.w( c ) );
+    for( ; c < n_bytes; ++c )         ct += popcount64( src.byte( c ) );
+    return ct;
+  } // popcount_src
+
+
+  /// Number of bits set in n_bytes bytes starting at ptr
+  inline
+  size_t
+  popcount( void const *ptr, size_t n_bytes ) noexcept
+  {
+    return
+      popcount_src( single_src{ static_cast<unsigned char const *>( ptr ) },
+                    n_bytes );
+  } // popcount
+
+
+  /// \brief Number of bits set in a op b, where each argument points
+  /// to n_bytes bytes. a op b is not stored.
+  inline
+  size_t
+  popcount_op( bitwise_op_type opt,
+               void const *a, void const *b, size_t n_bytes ) noexcept
+  {
+    auto const s1= static_cast<unsigned char const *>( a );
+    auto const s2= static_cast<unsigned char const *>( b );
+    switch( opt )
+    {
+      case bitwise_op_type::or_op:
+        return popcount_src( zip_src<bitwise_op_type::or_op>{ s1, s2 },
+                             n_bytes );
+      case bitwise_op_type::and_op:
+        return popcount_src( zip_src<bitwise_op_type::and_op>{ s1, s2 },
+                             n_bytes );
+      case bitwise_op_type::xor_op:
+        return popcount_src( zip_src<bitwise_op_type::xor_op>{ s1, s2 },
+                             n_bytes );
+      default:
+        return popcount_src( zip_src<bitwise_op_type::sdiff_op>{ s1, s2 },
+                             n_bytes );
+    }
+  } // popcount_op
+
+
+  /// True if the n_bytes bytes at a and b are equal
+  inline
+  bool
+  equal( void const *a, void const *b, size_t n_bytes ) noexcept
+  {
+    auto const p1= static_cast<unsigned char const *>( a );
+    auto const p2= static_cast<unsigned char const *>( b );
+    size_t     c=  0;
+#if defined(BITSET2_SIMD512)
+    for( ; c + 64 <= n_bytes; c += 64 )
+      if( _mm512_cmpneq_epi64_mask( _mm512_loadu_si512( p1 + c ),
+                                    _mm512_loadu_si512( p2 + c ) ) != 0 )
+                                                                  return false;
+#endif
+#if defined(BITSET2_SIMD256)
+    for( ; c + 32 <= n_bytes; c += 32 )
+    {
+      __m256i const x= _mm256_xor_si256( load256( p1 + c, 0 ),
+                                         load256( p2 + c, 0 ) );
+      if( !_mm256_testz_si256( x, x ) ) return false;
+    }
+#endif
+#if defined(BITSET2_SIMD128)
+    for( ; c + 16 <= n_bytes; c += 16 )
+    {
+      __m128i const eq=
+        _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast<__m128i const *>(p1+c) ),
+                        _mm_loadu_si128( reinterpret_cast<__m128i const *>(p2+c) ));
+      if( _mm_movemask_epi8( eq ) != 0xFFFF ) return false;
+    }
+#endif
+    return std::memcmp( p1 + c, p2 + c, n_bytes - c ) == 0;
+  } // equal
+
+
+  /// True if all n_bytes bytes at a are zero
+  inline
+  bool
+  none( void const *a, size_t n_bytes ) noexcept
+  {
+    auto const p= static_cast<unsigned char const *>( a );
+    size_t     c= 0;
+#if defined(BITSET2_SIMD512)
+    for( ; c + 256 <= n_bytes; c += 256 )
+    {
+      __m512i const acc=
+        _mm512_or_si512( _mm512_or_si512( _mm512_loadu_si512( p + c ),
+                                          _mm512_loadu_si512( p + c + 64 ) ),
+                         _mm512_or_si512( _mm512_loadu_si512( p + c + 128 ),
+                                          _mm512_loadu_si512( p + c + 192 ) ));
+      if( _mm512_test_epi64_mask( acc, acc ) != 0 ) return false;
+    }
+#endif
+#if defined(BITSET2_SIMD256)
+    for( ; c + 128 <= n_bytes; c += 128 )
+    {
+      __m256i const acc=
+        _mm256_or_si256( _mm256_or_si256( load256( p + c, 0 ),
+                                          load256( p + c, 1 ) ),
+                         _mm256_or_si256( load256( p + c, 2 ),
+                                          load256( p + c, 3 ) ) );
+      if( !_mm256_testz_si256( acc, acc ) ) return false;
+    }
+    for( ; c + 32 <= n_bytes; c += 32 )
+    {
+      __m256i const v= load256( p + c, 0 );
+      if( !_mm256_testz_si256( v, v ) ) return false;
+    }
+#endif
+#if defined(BITSET2_SIMD128)
+    for( ; c + 16 <= n_bytes; c += 16 )
+    {
+      __m128i const eq=
+        _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast<__m128i const *>(p+c) ),
+                        _mm_setzero_si128() );
+      if( _mm_movemask_epi8( eq ) != 0xFFFF ) return false;
+    }
+#endif
+    uint64_t acc= 0;
+    for( ; c + 8 <= n_bytes; c += 8 )
+    {
+      uint64_t v;
+      std::memcpy( &v, p + c, 8 );
+      acc |= v;
+    }
+    for( ; c < n_bytes; ++c ) acc |= p[c];
+    return acc == 0;
+  } // none
+
+
+  /// \brief Index of the most significant byte in which a and b differ.
+  /// Returns n_bytes if they are equal. Scans from the top, such that
+  /// the first difference found is the most significant one.
+  inline
+  size_t
+  idx_msb_diff( void const *a, void const *b, size_t n_bytes ) noexcept
+  {
+    auto const p1= static_cast<unsigned char const *>( a );
+    auto const p2= static_cast<unsigned char const *>( b );
+    size_t     c=  n_bytes;
+#if defined(BITSET2_SIMD512) && defined(__AVX512BW__)
+    for( ; c >= 64; c -= 64 )
+    {
+      auto const neq=
+        _mm512_cmpneq_epi8_mask( _mm512_loadu_si512( p1 + c - 64 ),
+                                 _mm512_loadu_si512( p2 + c - 64 ) );
+      if( neq != 0 )
+               return c - 64 + index_msb_set<uint64_t>()( uint64_t( neq ) );
+    }
+#endif
+#if defined(BITSET2_SIMD256)
+    for( ; c >= 32; c -= 32 )
+    {
+      auto const eq= unsigned( _mm256_movemask_epi8(
+                       _mm256_cmpeq_epi8( load256( p1 + c - 32, 0 ),
+                                          load256( p2 + c - 32, 0 ) ) ) );
+      if( eq != 0xFFFFFFFFu )
+               return c - 32 + index_msb_set<uint32_t>()( uint32_t( ~eq ) );
+    }
+#endif
+#if defined(BITSET2_SIMD128)
+    for( ; c >= 16; c -= 16 )
+    {
+      auto const eq= unsigned( _mm_movemask_epi8( _mm_cmpeq_epi8(
+               _mm_loadu_si128( reinterpret_cast<__m128i const *>(p1+c-16) ),
+               _mm_loadu_si128( reinterpret_cast<__m128i const *>(p2+c-16) ))));
+      if( eq != 0xFFFFu )
+            return c - 16 + index_msb_set<uint32_t>()( uint32_t( ~eq & 0xFFFFu ) );
+    }
+#endif
+    for( ; c > 0; --c ) if( p1[c-1] != p2[c-1] ) return c - 1;
+    return n_bytes;
+  } // idx_msb_diff
+
+
+
+  /// \brief Writes the indices of the bits set in v to out, offset by pos0.
+  /// Returns the number of indices written. At most max_n are written.
+  template<class IdxT>
+  inline
+  size_t
+  decode_word( uint64_t v, size_t pos0, IdxT *out, size_t max_n ) noexcept
+  {
+    size_t n= 0;
+    if( max_n >= 64 )
+    {
+      for( ; v != 0; v &= v - 1 )
+        out[n++]= IdxT( pos0 + index_lsb_set<uint64_t>()( v ) );
+      return n;
+    }
+    for( ; v != 0 && n < max_n; v &= v - 1 )
+      out[n++]= IdxT( pos0 + index_lsb_set<uint64_t>()( v ) );
+    return n;
+  } // decode_word
+
+
+  /// \brief Writes the indices of all bits set in n_bytes bytes to out
+  /// in ascending order. At most max_n indices are written.
+  /// Returns the number of indices written. With AVX-512 sixteen
+  /// (or with VBMI2 and 16 bit indices thirty two) candidate indices
+  /// are compressed into out per instruction, zero words are skipped.
+  /// Byte c holds bits [8c,8c+8), which requires a little-endian target.
+  template<class IdxT>
+  inline
+  size_t
+  decode_positions( void const *a, size_t n_bytes,
+                    IdxT *out, size_t max_n ) noexcept
+  {
+    static_assert( sizeof(IdxT) == 2 || sizeof(IdxT) == 4,
+                   "Index type must have 16 or 32 bits" );
+    auto const p= static_cast<unsigned char const *>( a );
+    size_t     n= 0;
+    size_t     c= 0;
+#if defined(BITSET2_SIMD512)
+    constexpr bool  cmprs16=
+# if defined(__AVX512VBMI2__)
+                             sizeof(IdxT) == 2;
+# else
+                             false;
+# endif
+    constexpr bool  cmprs32= sizeof(IdxT) == 4;
+#endif
+    for( ; c + 8 <= n_bytes; c += 8 )
+    {
+      uint64_t v;
+      std::memcpy( &v, p + c, 8 );
+      if( v == 0 ) continue;
+      auto const pos0= c * 8;
+#if defined(BITSET2_SIMD512)
+      if( ( cmprs32 || cmprs16 ) && max_n - n >= 64
+          && popcount64( v ) > rt_compress_min_bits )
+      {
+        if constexpr( cmprs32 )
+        {
+          auto       idx= _mm512_add_epi32( _mm512_set1_epi32( int( pos0 ) ),
+                                            _mm512_set_epi32( 15, 14, 13, 12,
+                                                              11, 10,  9,  8,
+                                                               7,  6,  5,  4,
+                                                               3,  2,  1,  0 ) );
+          auto const step= _mm512_set1_epi32( 16 );
+          for( size_t k= 0; k < 4; ++k, v >>= 16 )
+          {
+            auto const m= __mmask16( v & 0xFFFFu );
+            _mm512_mask_compressstoreu_epi32( out + n, m, idx );
+            n  += popcount64( m );
+            idx= _mm512_add_epi32( idx, step );
+          }
+        }
+# if defined(__AVX512VBMI2__)
+        else if constexpr( cmprs16 )
+        {
+          auto       idx= _mm512_add_epi16(
+                            _mm512_set1_epi16( short( pos0 ) ),
+                            _mm512_set_epi16( 31, 30, 29, 28, 27, 26, 25, 24,
+                                              23, 22, 21, 20, 19, 18, 17, 16,
+                                              15, 14, 13, 12, 11, 10,  9,  8,
+                                               7,  6,  5,  4,  3,  2,  1,  0 ));
+          auto const step= _mm512_set1_epi16( 32 );
+          for( size_t k= 0; k < 2; ++k, v >>= 32 )
+          {
+            auto const m= __mmask32( v & 0xFFFFFFFFu );
+            _mm512_mask_compressstoreu_epi16( out + n, m, idx );
+            n  += popcount64( m );
+            idx= _mm512_add_epi16( idx, step );
+          }
+        }
+# endif
+        continue;
+      }
+#endif
+      n += decode_word( v, pos0, out + n, max_n - n );
+      if( n == max_n ) return n;
+    } // for c
+    for( ; c < n_bytes && n < max_n; ++c )
+      n += decode_word( p[c], c * 8, out + n, max_n - n );
+    return n;
+  } // decode_positions
+
+} // namespace rt_kernels
+
+} // namespace detail
+} // namespace Bitset2
+
+
+
+#undef BITSET2_SIMD512
+#undef BITSET2_POPCNT512
+#undef BITSET2_SIMD256
+#undef BITSET2_SSSE3
+#undef BITSET2_SIMD128
+
+#endif // BITSET2_SIMD_KERNELS_CB_HPP
@@ -0,0 +1,874 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+#ifndef BITSET2_SIZED_BITSET_IMPL_CB_HPP
+#define BITSET2_SIZED_BITSET_IMPL_CB_HPP
+
+
+#include "word_funcs.hpp"
+#include "hex_params.hpp"
+#include <string>
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <cstdint>
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+
+/// \brief Common implementation of bitsets with a size given at runtime,
+/// i.e. dynamic_bitset2 and bounded_bitset2 (CRTP). Derived provides
+/// the storage by word_ptr() and n_words() and the number of bits by size().
+/// Bits above size() are kept zero. Binary operations require operands
+/// of equal size and throw std::invalid_argument otherwise.
+template<class Derived,class T>
+class sized_bitset_impl
+{
+  using w_funcs=  word_funcs<T>;
+
+protected:
+  enum : size_t { base_t_n_bits= h_types<T>::base_t_n_bits };
+
+public:
+  using base_t=         T;
+  using ULLONG_t=       typename h_types<T>::ULLONG_t;
+  using sized_bitset_tag= void;
+
+  enum : size_t { npos= h_types<T>::npos };
+
+  class reference
+  {
+    friend class sized_bitset_impl;
+
+    constexpr
+    reference( Derived *ptr, size_t bit ) noexcept
+    : m_ptr( ptr )
+    , m_bit( bit )
+    {}
+
+    Derived *m_ptr;
+    size_t  m_bit;
+  public:
+    constexpr
+    reference& operator=( bool x ) noexcept
+    {
+      m_ptr->set_noexcept( m_bit, x );
+      return *this;
+    }
+
+    constexpr
+    reference& operator=( reference const & r ) noexcept
+    {
+      m_ptr->set_noexcept( m_bit, bool( r ) );
+      return *this;
+    }
+
+    constexpr
+    reference& flip() noexcept
+    {
+      m_ptr->flip_noexcept( m_bit );
+      return *this;
+    }
+
+    constexpr
+    operator bool() const noexcept
+    { return m_ptr->test_noexcept(m_bit); }
+
+    constexpr
+    bool operator~() const noexcept
+    { return !bool(*this); }
+  }; // class reference
+
+
+  //** Element access
+
+  constexpr
+  bool
+  operator[]( size_t bit ) const noexcept
+  { return test_noexcept( bit ); }
+
+  constexpr
+  reference
+  operator[]( size_t bit ) noexcept
+  { return reference( &derived(), bit ); }
+
+  constexpr
+  bool
+  test( size_t bit ) const
+  {
+    return  ( bit >= size() )
+            ? throw std::out_of_range( "bitset2: Testing of bit out of range" )
+            : test_noexcept( bit );
+  }
+
+  constexpr
+  bool
+  test_noexcept( size_t bit ) const noexcept
+  { return words()[bit / base_t_n_bits] & ( T(1) << ( bit % base_t_n_bits ) ); }
+
+  constexpr
+  Derived &
+  set() noexcept
+  {
+    wf().set_all( words() );
+    return derived();
+  }
+
+  constexpr
+  Derived &
+  set( size_t bit, bool value= true )
+  {
+    if( bit >= size() )
+            throw std::out_of_range( "bitset2: Setting of bit out of range" );
+    set_noexcept( bit, value );
+    return derived();
+  }
+
+  constexpr
+  void
+  set_noexcept( size_t bit, bool value= true ) noexcept
+  {
+    if( value ) words()[bit / base_t_n_bits]
+                   |=  base_t(   base_t(1) << ( bit % base_t_n_bits )  );
+    else        words()[bit / base_t_n_bits]
+                   &=  base_t(~( base_t(1) << ( bit % base_t_n_bits ) ));
+  }
+
+  constexpr
+  Derived &
+  reset() noexcept
+  {
+    for( size_t c= 0; c < n_words(); ++c ) words()[c]= base_t(0);
+    return derived();
+  }
+
+  constexpr
+  Derived &
+  reset( size_t bit )
+  {
+    if( bit >= size() ) throw std::out_of_range( "bitset2: reset out of range" );
+    set_noexcept( bit, false );
+    return derived();
+  }
+
+  /// \brief Sets the specified bit if value==true,
+  /// clears it otherwise. Returns the previous state of the bit.
+  constexpr
+  bool
+  test_set( size_t bit, bool value= true )
+  {
+    auto const ret_val= test( bit );
+    set_noexcept( bit, value );
+    return ret_val;
+  }
+
+  constexpr
+  Derived &
+  flip() noexcept
+  {
+    wf().flip_assgn( words() );
+    return derived();
+  }
+
+  constexpr
+  Derived &
+  flip( size_t bit )
+  {
+    if( bit >= size() )
+            throw std::out_of_range( "bitset2: Flipping of bit out of range" );
+    return flip_noexcept( bit );
+  }
+
+  constexpr
+  Derived &
+  flip_noexcept( size_t bit ) noexcept
+  {
+    words()[bit / base_t_n_bits] ^= ( base_t(1) << ( bit % base_t_n_bits ) );
+    return derived();
+  }
+
+  /// \brief Sets the bits in [lo, hi). Only the words overlapping the
+  /// range are touched. Throws out_of_range unless lo <= hi <= size().
+  constexpr
+  Derived &
+  set_range( size_t lo, size_t hi )
+  {
+    check_range( lo, hi, "bitset2: set_range out of range" );
+    wf().set_range( words(), lo, hi );
+    return derived();
+  }
+
+  /// Clears the bits in [lo, hi), see set_range
+  constexpr
+  Derived &
+  reset_range( size_t lo, size_t hi )
+  {
+    check_range( lo, hi, "bitset2: reset_range out of range" );
+    wf().reset_range( words(), lo, hi );
+    return derived();
+  }
+
+  /// Flips the bits in [lo, hi), see set_range
+  constexpr
+  Derived &
+  flip_range( size_t lo, size_t hi )
+  {
+    check_range( lo, hi, "bitset2: flip_range out of range" );
+    wf().flip_range( words(), lo, hi );
+    return derived();
+  }
+
+
+  //** Queries
+
+  constexpr bool   none()  const noexcept { return wf().none( words() ); }
+  constexpr bool   any()   const noexcept { return !none(); }
+  constexpr bool   all()   const noexcept { return wf().all( words() ); }
+  constexpr size_t count() const noexcept { return wf().count( words() ); }
+
+  /// Number of bits set in [lo, hi), see set_range
+  constexpr
+  size_t
+  count_range( size_t lo, size_t hi ) const
+  {
+    check_range( lo, hi, "bitset2: count_range out of range" );
+    return wf().count_range( words(), lo, hi );
+  }
+
+  /// True if any bit in [lo, hi) is set, see set_range
+  constexpr
+  bool
+  any_in_range( size_t lo, size_t hi ) const
+  {
+    check_range( lo, hi, "bitset2: any_in_range out of range" );
+    return wf().any_in_range( words(), lo, hi );
+  }
+
+  /// True if exactly one bit set.
+  constexpr
+  bool
+  has_single_bit() const noexcept
+  { return wf().has_single_bit( words() ); }
+
+  /// \brief Returns index of first (least significant) bit set.
+  /// Returns npos if all bits are zero.
+  constexpr
+  size_t
+  find_first() const noexcept
+  {
+    return   size() == 0 ? size_t(npos)
+           : wf().idx_lsb_set( words(), words()[0], 0, base_t(2) );
+  }
+
+  /// \brief Returns index of first (least significant) bit unset.
+  /// Returns npos if all bits are set.
+  constexpr
+  size_t
+  find_first_zero() const noexcept
+  {
+    return   size() == 0 ? size_t(npos)
+           : wf().idx_lsb_set( words(), base_t(~words()[0]), 0,
+                               wf().hgh_bit_pattern() );
+  }
+
+  /// \brief Returns index of last (most significant) bit set.
+  /// Returns npos if all bits are zero.
+  constexpr
+  size_t
+  find_last() const noexcept
+  { return wf().idx_msb_set( words(), base_t(2) ); }
+
+  /// \brief Returns index of last (most significant) bit unset.
+  /// Returns npos if all bits are set.
+  constexpr
+  size_t
+  find_last_zero() const noexcept
+  { return wf().idx_msb_set( words(), wf().hgh_bit_pattern() ); }
+
+  /// \brief Returns index of next (> idx) bit set.
+  /// Returns npos if no more bits set.
+  /// Throws out_of_range if idx >= size().
+  constexpr
+  size_t
+  find_next( size_t idx ) const
+  {
+    return idx >= size()
+      ? throw std::out_of_range( "bitset2: find_next index out of range" )
+      : wf().find_next( words(), idx, false );
+  }
+
+  /// \brief Returns index of next (> idx) bit unset.
+  /// Returns npos if no more bits unset.
+  /// Throws out_of_range if idx >= size().
+  constexpr
+  size_t
+  find_next_zero( size_t idx ) const
+  {
+    return idx >= size()
+      ? throw std::out_of_range( "bitset2: find_next index out of range" )
+      : wf().find_next( words(), idx, true );
+  }
+
+  /// \brief Returns number of bits set below position idx.
+  /// Throws out_of_range if idx > size().
+  constexpr
+  size_t
+  rank( size_t idx ) const
+  {
+    return idx > size()
+      ? throw std::out_of_range( "bitset2: rank index out of range" )
+      : wf().rank( words(), idx );
+  }
+
+  /// \brief Returns index of k-th (counting from zero) bit set.
+  /// Returns npos if less than k+1 bits are set.
+  constexpr
+  size_t
+  select( size_t k ) const noexcept
+  { return wf().select( words(), k ); }
+
+  /// \brief Writes the indices of all set bits in ascending order to out,
+  /// which must provide room for count() values. Returns the number
+  /// of indices written. Throws overflow_error if size() exceeds the
+  /// range of IdxT.
+  template<class IdxT,
+           typename std::enable_if<
+                        std::is_same<IdxT,uint32_t>::value
+                     || std::is_same<IdxT,uint16_t>::value >::type* = nullptr>
+  constexpr
+  size_t
+  decode_positions( IdxT *out ) const
+  {
+    return size() > size_t( IdxT(~IdxT(0)) ) + 1
+      ? throw std::overflow_error( "bitset2: Indices exceed index type" )
+      : wf().decode_positions( words(), out, npos );
+  }
+
+
+  //** Bitwise operators
+
+  /// Bitwise NOT
+  constexpr
+  Derived
+  operator~() const
+  {
+    Derived ret_val( derived() );
+    return std::move( ret_val.flip() );
+  }
+
+  constexpr
+  Derived &
+  operator&=( Derived const & v2 )
+  { return bitwise_op_assgn( bitwise_op_type::and_op, v2 ); }
+
+  constexpr
+  Derived &
+  operator|=( Derived const & v2 )
+  { return bitwise_op_assgn( bitwise_op_type::or_op, v2 ); }
+
+  constexpr
+  Derived &
+  operator^=( Derived const & v2 )
+  { return bitwise_op_assgn( bitwise_op_type::xor_op, v2 ); }
+
+  /// Computes the set difference, i.e. *this &= ~v2
+  constexpr
+  Derived &
+  difference( Derived const & v2 )
+  { return bitwise_op_assgn( bitwise_op_type::sdiff_op, v2 ); }
+
+  friend
+  constexpr
+  Derived
+  operator&( Derived bs1, Derived const & bs2 )
+  { return std::move( bs1 &= bs2 ); }
+
+  friend
+  constexpr
+  Derived
+  operator|( Derived bs1, Derived const & bs2 )
+  { return std::move( bs1 |= bs2 ); }
+
+  friend
+  constexpr
+  Derived
+  operator^( Derived bs1, Derived const & bs2 )
+  { return std::move( bs1 ^= bs2 ); }
+
+
+  //** Shifts, rotations, arithmetic
+
+  constexpr
+  Derived &
+  operator<<=( size_t n_shift ) noexcept
+  {
+    wf().shift_left_assgn( words(), n_shift );
+    return derived();
+  }
+
+  constexpr
+  Derived &
+  operator>>=( size_t n_shift ) noexcept
+  {
+    wf().shift_right_assgn( words(), n_shift );
+    return derived();
+  }
+
+  /// Shift left
+  friend
+  constexpr
+  Derived
+  operator<<( Derived bs, size_t n_shift )
+  { return std::move( bs <<= n_shift ); }
+
+  /// Shift right
+  friend
+  constexpr
+  Derived
+  operator>>( Derived bs, size_t n_shift )
+  { return std::move( bs >>= n_shift ); }
+
+  /// Rotates in place, without a copy
+  constexpr
+  Derived &
+  rotate_left( size_t n_rot ) noexcept
+  {
+    wf().rotate_assgn( words(), n_rot );
+    return derived();
+  }
+
+  constexpr
+  Derived &
+  rotate_right( size_t n_rot ) noexcept
+  {
+    if( size() == 0 ) return derived();
+    return rotate_left( size() - ( n_rot % size() ) );
+  }
+
+  /// Reverses in place, without a copy
+  constexpr
+  Derived &
+  reverse() noexcept
+  {
+    wf().reverse_assgn( words() );
+    return derived();
+  }
+
+  /// Computes two's complement
+  constexpr
+  Derived &
+  complement2() noexcept
+  {
+    wf().comp2_assgn( words() );
+    return derived();
+  }
+
+  constexpr
+  Derived &
+  operator+=( Derived const &bs2 )
+  {
+    check_size( bs2 );
+    wf().add_assgn( words(), bs2.words() );
+    return derived();
+  }
+
+  friend
+  constexpr
+  Derived
+  operator+( Derived bs1, Derived const & bs2 )
+  { return std::move( bs1 += bs2 ); }
+
+  constexpr
+  Derived &
+  operator++() noexcept
+  {
+    wf().increment( words() );
+    return derived();
+  }
+
+  constexpr
+  Derived
+  operator++(int)
+  {
+    Derived tmp( derived() );
+    operator++();
+    return tmp;
+  }
+
+  constexpr
+  Derived &
+  operator--() noexcept
+  {
+    wf().decrement( words() );
+    return derived();
+  }
+
+  constexpr
+  Derived
+  operator--(int)
+  {
+    Derived tmp( derived() );
+    operator--();
+    return tmp;
+  }
+
+
+  //** Comparison. Bitsets of different size are ordered by size.
+
+  friend
+  constexpr
+  bool
+  operator==( Derived const &bs1, Derived const &bs2 ) noexcept
+  {
+    return    bs1.size() == bs2.size()
+           && bs1.wf().equal( bs1.words(), bs2.words() );
+  }
+
+  friend
+  constexpr
+  bool
+  operator!=( Derived const &bs1, Derived const &bs2 ) noexcept
+  { return !( bs1 == bs2 ); }
+
+  friend
+  constexpr
+  bool
+  operator<( Derived const &bs1, Derived const &bs2 ) noexcept
+  { return bs1.compare( bs2 ) < 0; }
+
+  friend
+  constexpr
+  bool
+  operator>( Derived const &bs1, Derived const &bs2 ) noexcept
+  { return bs1.compare( bs2 ) > 0; }
+
+  friend
+  constexpr
+  bool
+  operator<=( Derived const &bs1, Derived const &bs2 ) noexcept
+  { return bs1.compare( bs2 ) <= 0; }
+
+  friend
+  constexpr
+  bool
+  operator>=( Derived const &bs1, Derived const &bs2 ) noexcept
+  { return bs1.compare( bs2 ) >= 0; }
+
+  /// Returns -1, 0, or 1 if *this is less, equal, or greater than bs2
+  constexpr
+  int
+  compare( Derived const &bs2 ) const noexcept
+  {
+    if( size() != bs2.size() ) return size() < bs2.size() ? -1 : 1;
+    return wf().compare( words(), bs2.words() );
+  }
+
+
+  //** Conversions
+
+  constexpr
+  ULLONG_t
+  to_ullong() const
+  {
+    constexpr size_t ullong_n_bits= h_types<T>::ullong_n_bits;
+    if( find_last() != npos && find_last() >= ullong_n_bits )
+      throw std::overflow_error( "Cannot convert bitset2 "
+                                 "to unsigned long long" );
+    ULLONG_t ret_val= 0;
+    for( size_t c= 0; c < n_words() && c * base_t_n_bits < ullong_n_bits; ++c )
+      ret_val |= ce_left_shift( ULLONG_t( words()[c] ), c * base_t_n_bits );
+    return ret_val;
+  } // to_ullong
+
+  constexpr
+  unsigned long
+  to_ulong() const
+  {
+    constexpr size_t ulong_n_bits= h_types<T>::ulong_n_bits;
+    if( find_last() != npos && find_last() >= ulong_n_bits )
+      throw std::overflow_error( "Cannot convert bitset2 "
+                                 "to unsigned long" );
+    return (unsigned long)( to_ullong() );
+  } // to_ulong
+
+  template<class CharT = char,
+           class Traits = std::char_traits<CharT>,
+           class Allocator = std::allocator<CharT> >
+  std::basic_string<CharT,Traits,Allocator>
+  to_string( CharT zero = CharT('0'), CharT one = CharT('1') ) const
+  {
+    std::basic_string<CharT,Traits,Allocator> ret_val;
+    ret_val.reserve( size() );
+    for( size_t ct= size(); ct > 0; )
+    {
+      --ct;
+      ret_val += test_noexcept( ct ) ? one : zero;
+    }
+    return ret_val;
+  } // to_string
+
+  template<class CharT = char,
+           class Traits = std::char_traits<CharT>,
+           class Allocator = std::allocator<CharT>,
+           typename std::enable_if<base_t_n_bits % 4 == 0>::type* = nullptr >
+  std::basic_string<CharT,Traits,Allocator>
+  to_hex_string( hex_params<CharT,Traits,Allocator> const &params=
+                 hex_params<CharT,Traits,Allocator>{} ) const
+  {
+    auto const      n_char= size() / 4 + ( size() % 4 > 0 );
+    auto const      zeroCh= params.zeroCh;
+    auto const      aCh=    params.aCh;
+
+    std::basic_string<CharT,Traits,Allocator> ret_val;
+    ret_val.reserve( n_char + params.prefix.size() );
+    ret_val= params.prefix;
+    size_t ct= n_char;
+    if( !params.leadingZeroes )
+    {
+      for( ; ct > 0; --ct )
+      {
+        auto  const val= w_funcs::get_four_bits( words(), 4 * ct - 1 );
+        if( val != 0 ) break;
+      }
+    }
+    if( ct == 0 && params.nonEmpty ) ret_val += zeroCh;
+    for( ; ct > 0; --ct )
+    {
+      auto  const val= w_funcs::get_four_bits( words(), 4 * ct - 1 );
+      CharT const c=
+      ( val < 10 ) ? CharT( zeroCh + val ) : CharT( aCh + ( val - 10 ) );
+      ret_val += c;
+    }
+    return ret_val;
+  } // to_hex_string
+
+  /// Stream output
+  template <class CharT, class Traits>
+  friend
+  std::basic_ostream<CharT, Traits> &
+  operator<<( std::basic_ostream<CharT, Traits> & os, Derived const & x )
+  { return os << x.to_string( CharT('0'), CharT('1') ); }
+
+protected:
+  constexpr
+  sized_bitset_impl() noexcept= default;
+
+  constexpr Derived       & derived()       noexcept
+  { return static_cast<Derived &>( *this ); }
+  constexpr Derived const & derived() const noexcept
+  { return static_cast<Derived const &>( *this ); }
+
+  constexpr size_t  size()    const noexcept { return derived().size(); }
+  constexpr size_t  n_words() const noexcept { return derived().n_words(); }
+  constexpr T       *words()        noexcept { return derived().word_ptr(); }
+  constexpr T const *words()  const noexcept { return derived().word_ptr(); }
+
+  /// Algorithms for the current size
+  constexpr
+  w_funcs
+  wf() const noexcept
+  { return w_funcs( size(), n_words() ); }
+
+  /// Clears the bits above size() in the most significant word
+  constexpr
+  void
+  mask_hgh_bits() noexcept
+  { if( n_words() > 0 ) words()[n_words()-1] &= wf().hgh_bit_pattern(); }
+
+  /// Sets the lowest bits to value, requires mask_hgh_bits() afterwards
+  constexpr
+  void
+  assign_ullong( ULLONG_t value ) noexcept
+  {
+    for( size_t c= 0; c < n_words() && value != 0; ++c )
+    {
+      words()[c]= T( value );
+      value= ce_right_shift( value, base_t_n_bits );
+    }
+  }
+
+  /// Number of bits taken from a string submitted to a constructor
+  template< class CharT, class Traits, class SAlloc >
+  static
+  size_t
+  string_n_bits( std::basic_string<CharT,Traits,SAlloc> const &str,
+                 size_t pos, size_t n )
+  {
+    if( pos > str.size() )
+            throw std::out_of_range( "bitset2: String submitted to "
+                                     "constructor smaller than pos" );
+    return std::min( n, str.size() - pos );
+  }
+
+  /// Sets bits from str, where size() equals string_n_bits( str, pos, n )
+  template< class CharT, class Traits, class SAlloc >
+  void
+  assign_string( std::basic_string<CharT,Traits,SAlloc> const &str,
+                 size_t pos, CharT zero, CharT one )
+  {
+    auto const n_bits= size();
+    for( size_t bit_ct= 0; bit_ct < n_bits; ++bit_ct )
+    {
+      auto const chr= str[bit_ct+pos];
+      if(       Traits::eq( one,  chr ) ) set_noexcept( n_bits - bit_ct - 1 );
+      else if( !Traits::eq( zero, chr ) )
+              throw std::invalid_argument( "bitset2: Invalid argument in "
+                                           "string submitted to constructor" );
+    } // for bit_ct
+  }
+
+  constexpr
+  void
+  check_size( Derived const &bs2 ) const
+  {
+    if( size() != bs2.size() )
+      throw std::invalid_argument( "bitset2: Sizes of operands differ" );
+  }
+
+  /// Throws out_of_range unless lo <= hi <= size()
+  constexpr
+  void
+  check_range( size_t lo, size_t hi, char const *msg ) const
+  { if( lo > hi || hi > size() ) throw std::out_of_range( msg ); }
+
+  constexpr
+  Derived &
+  bitwise_op_assgn( bitwise_op_type opt, Derived const &v2 )
+  {
+    check_size( v2 );
+    wf().bitwise_op( opt, words(), words(), v2.words() );
+    return derived();
+  }
+}; // class sized_bitset_impl
+
+
+/// True if B is derived from sized_bitset_impl
+template<class B,class Enabled=void>
+struct is_sized_bitset : std::false_type {};
+
+template<class B>
+struct is_sized_bitset<B,typename B::sized_bitset_tag> : std::true_type {};
+
+
+} // namespace detail
+
+
+
+/// \brief Free functions for dynamic_bitset2 and bounded_bitset2.
+/// They follow those of bitset2.
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+B
+rotate_left( B bs, size_t n_rot )
+{ return std::move( bs.rotate_left( n_rot ) ); }
+
+
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+B
+rotate_right( B bs, size_t n_rot )
+{ return std::move( bs.rotate_right( n_rot ) ); }
+
+
+/// Computes the set difference, i.e. bs1 & ~bs2
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+B
+difference( B bs1, B const & bs2 )
+{ return std::move( bs1.difference( bs2 ) ); }
+
+
+/// Returns bs with bits reversed
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+B
+reverse( B bs )
+{ return std::move( bs.reverse() ); }
+
+
+/// Computes the two's complement
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+B
+complement2( B bs )
+{ return std::move( bs.complement2() ); }
+
+
+namespace detail
+{
+  /// Number of bits set in bs1 opt bs2, throws if sizes differ
+  template<class B>
+  constexpr
+  size_t
+  sized_count_op( bitwise_op_type opt, B const & bs1, B const & bs2 )
+  {
+    return   bs1.size() != bs2.size()
+           ? throw std::invalid_argument( "bitset2: Sizes of operands differ" )
+           : word_funcs<typename B::base_t>( bs1.size(), bs1.n_words() )
+                                  .count_op( opt, bs1.data(), bs2.data() );
+  }
+} // namespace detail
+
+
+/// Number of bits set in bs1 & bs2, without computing bs1 & bs2
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+size_t
+count_and( B const & bs1, B const & bs2 )
+{ return detail::sized_count_op( detail::bitwise_op_type::and_op, bs1, bs2 ); }
+
+
+/// Number of bits set in bs1 | bs2, without computing bs1 | bs2
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+size_t
+count_or( B const & bs1, B const & bs2 )
+{ return detail::sized_count_op( detail::bitwise_op_type::or_op, bs1, bs2 ); }
+
+
+/// Hamming distance, i.e. number of bits set in bs1 ^ bs2
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+size_t
+count_xor( B const & bs1, B const & bs2 )
+{ return detail::sized_count_op( detail::bitwise_op_type::xor_op, bs1, bs2 ); }
+
+
+/// Number of bits set in bs1 & ~bs2
+template<class B,
+         typename std::enable_if<detail::is_sized_bitset<B>::value>::type* = nullptr>
+constexpr
+size_t
+count_difference( B const & bs1, B const & bs2 )
+{ return detail::sized_count_op( detail::bitwise_op_type::sdiff_op, bs1, bs2 ); }
+
+
+} // namespace Bitset2
+
+
+
+
+#endif // BITSET2_SIZED_BITSET_IMPL_CB_HPP
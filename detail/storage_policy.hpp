@@ -0,0 +1,182 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+#ifndef BITSET2_STORAGE_POLICY_CB_HPP
+#define BITSET2_STORAGE_POLICY_CB_HPP
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+
+namespace Bitset2
+{
+namespace detail
+{
+  /// Arena taking memory from the global operator new
+  struct new_delete_arena
+  {
+    static
+    void *
+    allocate( std::size_t n_bytes, std::size_t alignment )
+    { return ::operator new( n_bytes, std::align_val_t( alignment ) ); }
+
+    static
+    void
+    deallocate( void *p, std::size_t n_bytes, std::size_t alignment ) noexcept
+    { ::operator delete( p, n_bytes, std::align_val_t( alignment ) ); }
+  }; // struct new_delete_arena
+} // namespace detail
+
+
+/// \brief Storage policy of bitset2: The words are held in a std::array
+/// inside the object. This is the default and the only policy which
+/// allows for constexpr.
+struct inline_storage {};
+
+/// \brief Storage policy of bitset2: The words are held in a block
+/// allocated from Arena, which needs the static member functions
+///   void *allocate( size_t n_bytes, size_t alignment );
+///   void deallocate( void *p, size_t n_bytes, size_t alignment ) noexcept;
+/// Each bitset2 owns its block. Copies allocate a new block, moves
+/// exchange the pointers. A moved-from bitset2 may only be assigned
+/// to or destroyed.
+template<class Arena>
+struct arena_storage {};
+
+/// \brief Storage policy of bitset2: The words are held in a block
+/// on the heap, see arena_storage.
+using heap_storage= arena_storage<detail::new_delete_arena>;
+
+
+namespace detail
+{
+  template<class S>
+  struct is_storage_policy : std::false_type {};
+
+  template<>
+  struct is_storage_policy<inline_storage> : std::true_type {};
+
+  template<class Arena>
+  struct is_storage_policy<arena_storage<Arena> > : std::true_type {};
+
+  template<class S>
+  struct is_inline_storage : std::is_same<S,inline_storage> {};
+
+
+  /// Tag for constructing a storage_holder from the result of a generator
+  struct gen_tag {};
+
+
+  /// Holds array A as requested by storage policy S
+  template<class S,class A> class storage_holder;
+
+
+  template<class A>
+  class storage_holder<inline_storage,A>
+  {
+  public:
+    enum : bool { is_inline= true };
+
+    constexpr
+    storage_holder() noexcept
+    : m_arr{}
+    {}
+
+    template<class F>
+    constexpr
+    storage_holder( gen_tag, F f ) noexcept
+    : m_arr( f() )
+    {}
+
+    constexpr A       & get()       noexcept { return m_arr; }
+    constexpr A const & get() const noexcept { return m_arr; }
+
+  private:
+    A    m_arr;
+  }; // class storage_holder<inline_storage,A>
+
+
+  template<class Arena,class A>
+  class storage_holder<arena_storage<Arena>,A>
+  {
+  public:
+    enum : bool { is_inline= false };
+
+    /// Zero initialized
+    storage_holder()
+    : m_ptr( ::new( alloc() ) A{} )
+    {}
+
+    /// \brief The result of f() is constructed in the allocated block
+    /// (guaranteed copy elision).
+    template<class F>
+    storage_holder( gen_tag, F f )
+    : m_ptr( nullptr )
+    {
+      void *p= alloc();
+      try { m_ptr= ::new( p ) A( f() ); }
+      catch( ... ) { dealloc( p ); throw; }
+    }
+
+    storage_holder( storage_holder const &other )
+    : m_ptr( ::new( alloc() ) A( other.get() ) )
+    {}
+
+    storage_holder( storage_holder &&other ) noexcept
+    : m_ptr( std::exchange( other.m_ptr, nullptr ) )
+    {}
+
+    storage_holder &
+    operator=( storage_holder const &other )
+    {
+      if( m_ptr == nullptr ) m_ptr= ::new( alloc() ) A( other.get() );
+      else                   *m_ptr= other.get();
+      return *this;
+    }
+
+    storage_holder &
+    operator=( storage_holder &&other ) noexcept
+    {
+      std::swap( m_ptr, other.m_ptr );
+      return *this;
+    }
+
+    ~storage_holder()
+    { if( m_ptr != nullptr ) dealloc( m_ptr ); }
+
+    A       & get()       noexcept { return *m_ptr; }
+    A const & get() const noexcept { return *m_ptr; }
+
+  private:
+    static_assert( std::is_trivially_destructible<A>::value,
+                   "storage_holder: A must be trivially destructible" );
+
+    static
+    void *
+    alloc()
+    { return Arena::allocate( sizeof(A), alignof(A) ); }
+
+    static
+    void
+    dealloc( void *p ) noexcept
+    { Arena::deallocate( p, sizeof(A), alignof(A) ); }
+
+    A    *m_ptr;
+  }; // class storage_holder<arena_storage<Arena>,A>
+
+} // namespace detail
+} // namespace Bitset2
+
+
+#endif // BITSET2_STORAGE_POLICY_CB_HPP
@@ -0,0 +1,1071 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+#ifndef BITSET2_WORD_FUNCS_CB_HPP
+#define BITSET2_WORD_FUNCS_CB_HPP
+
+
+#include "h_types.hpp"
+#include "count_bits.hpp"
+#include "index_lsb_set.hpp"
+#include "index_msb_set.hpp"
+#include "select_bit_set.hpp"
+#include "reverse_bits.hpp"
+#include "extract_deposit.hpp"
+#include "simd_kernels.hpp"
+#include <cstring>
+
+#if __cplusplus >= 202002L
+# include <bit>
+# ifdef __cpp_lib_int_pow2
+#  define CMPLRPOW2
+# endif
+#endif
+
+
+namespace Bitset2
+{
+namespace detail
+{
+#ifdef CMPLRPOW2
+  template<class T>
+  constexpr
+  bool loc_test_single_bit( T val )
+  { return std::has_single_bit( val ); }
+#else
+  template<class T>
+  constexpr
+  bool loc_test_single_bit( T val )
+  { return (val & T(val - T(1))) == T(0); }
+#endif
+
+#ifdef __SIZEOF_INT128__
+  /// Popcount on both 64 bit halves
+  template<>
+  constexpr
+  bool loc_test_single_bit( unsigned __int128 val )
+  { return count_bits( val ) == 1; }
+#endif
+
+
+  /// \brief Word offset and bit shift of a shift by n_shift bits,
+  /// computed once for any number of shifts, see word_funcs::plan_shift_left
+  template<class T>
+  struct shift_plan
+  {
+    enum : size_t { base_t_n_bits= h_types<T>::base_t_n_bits };
+
+    explicit
+    constexpr
+    shift_plan( size_t n_shift ) noexcept
+    : div( n_shift / base_t_n_bits )
+    , mod( n_shift % base_t_n_bits )
+    , lr_shift( base_t_n_bits - mod )
+    {}
+
+    size_t  div;
+    size_t  mod;
+    size_t  lr_shift;
+  }; // struct shift_plan
+
+
+  /// Like shift_plan with the members being constants for the shift K
+  template<class T,size_t K>
+  struct ct_shift_plan
+  {
+    enum : size_t {   base_t_n_bits= h_types<T>::base_t_n_bits
+                    , div=           K / base_t_n_bits
+                    , mod=           K % base_t_n_bits
+                    , lr_shift=      base_t_n_bits - mod };
+  }; // struct ct_shift_plan
+
+
+  /// \brief Word level algorithms on n_bits bits stored in a contiguous
+  /// sequence of words of type T, least significant word first.
+  /// The sequence is passed as a pointer, its length is the number of
+  /// words required for n_bits. Bits above n_bits are expected to be
+  /// zero and are kept zero. Used by array_funcs, array_ops and
+  /// array_add for std::array's and by dynamic_bitset2.
+  template<class T>
+  struct word_funcs
+  {
+    using base_t=  T;
+    using op_type= bitwise_op_type;
+
+    enum : size_t { base_t_n_bits=  h_types<T>::base_t_n_bits
+                  , npos=           h_types<T>::npos };
+
+    /// Words on the stack for the bits which wrap around in rotate_assgn
+    enum : size_t { rot_buf_n_words= 256 / sizeof(T)
+                  , rot_buf_n_bits=  256 * CHAR_BIT };
+
+    /// Number of words required for n_bits
+    static
+    constexpr
+    size_t
+    n_words_for( size_t n_bits ) noexcept
+    { return n_bits / base_t_n_bits + ( n_bits % base_t_n_bits != 0 ); }
+
+    explicit
+    constexpr
+    word_funcs( size_t n_bits ) noexcept
+    : word_funcs( n_bits, n_words_for( n_bits ) )
+    {}
+
+    /// n_words must equal n_words_for( n_bits )
+    constexpr
+    word_funcs( size_t n_bits, size_t n_words ) noexcept
+    : m_n_bits( n_bits )
+    , m_n_words( n_words )
+    , m_mod_val( n_bits % base_t_n_bits )
+    , m_hgh_bit_pattern(   n_bits == 0     ? base_t(0)
+                         : m_mod_val == 0  ? all_one()
+                         : ce_right_shift( all_one(), base_t_n_bits - m_mod_val ) )
+    {}
+
+    constexpr size_t n_bits()          const noexcept { return m_n_bits; }
+    constexpr size_t n_words()         const noexcept { return m_n_words; }
+    constexpr base_t hgh_bit_pattern() const noexcept { return m_hgh_bit_pattern; }
+
+
+    /// dst= arr1 opt arr2, dst may equal arr1 or arr2
+    constexpr
+    void
+    bitwise_op( op_type opt, T *dst,
+                T const *arr1, T const *arr2 ) const noexcept
+    {
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+      {
+        rt_kernels::bitwise_op( opt, dst, arr1, arr2, n_bytes() );
+        return;
+      }
+      for( size_t c= 0; c < m_n_words; ++c )
+                                   dst[c]= h_bitwise_op( opt, arr1[c], arr2[c] );
+    } // bitwise_op
+
+    /// \brief dst= f( arr1, arr2, arr3 ), where f is given by the truth
+    /// table imm (see ce_ternary). dst may equal any of the arguments.
+    /// Bits above n_bits are cleared, since f( 0, 0, 0 ) may be one.
+    template<uint8_t imm>
+    constexpr
+    void
+    ternary_op( T *dst, T const *arr1, T const *arr2,
+                T const *arr3 ) const noexcept
+    {
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+        rt_kernels::ternary_op<imm>( dst, arr1, arr2, arr3, n_bytes() );
+      else
+        for( size_t c= 0; c < m_n_words; ++c )
+                           dst[c]= ce_ternary<imm>( arr1[c], arr2[c], arr3[c] );
+      if( m_n_words > 0 ) dst[m_n_words-1] &= m_hgh_bit_pattern;
+    } // ternary_op
+
+    static
+    constexpr
+    base_t
+    h_bitwise_op( op_type opt, base_t v1, base_t v2 ) noexcept
+    {
+      switch( opt )
+      {
+        case op_type::or_op:  return v1 | v2;
+        case op_type::and_op: return v1 & v2;
+        case op_type::xor_op: return v1 ^ v2;
+        default: return v1 & base_t(~v2);      // set difference
+      } // switch
+    } // h_bitwise_op
+
+
+    constexpr
+    bool
+    none( T const *arr ) const noexcept
+    {
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+                                       return rt_kernels::none( arr, n_bytes() );
+      for( size_t c= m_n_words; c > 0; --c )
+      {
+        if( arr[c-1] != base_t(0) ) return false;
+      }
+      return true;
+    } // none
+
+
+    constexpr
+    bool
+    all( T const *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return false;
+      for( size_t c= 0; c + 1 < m_n_words; ++c )
+      {
+        if( arr[c] != all_one() ) return false;
+      }
+      return arr[m_n_words-1] == m_hgh_bit_pattern;
+    } // all
+
+
+    constexpr
+    size_t
+    count( T const *arr ) const noexcept
+    {
+      if( n_bytes() >= rt_popcount_min_bytes && use_rt_kernels() )
+                                  return rt_kernels::popcount( arr, n_bytes() );
+      return count_impl( arr );
+    }
+
+
+    /// Counts word by word, used during constant evaluation
+    constexpr
+    size_t
+    count_impl( T const *arr ) const noexcept
+    {
+      size_t ct = 0;
+      for( size_t c= 0; c < m_n_words; ++c ) ct += count_bits( arr[c] );
+      return ct;
+    }
+
+
+    /// Number of bits set in arr1 opt arr2
+    constexpr
+    size_t
+    count_op( op_type opt, T const *arr1, T const *arr2 ) const noexcept
+    {
+      if( n_bytes() >= rt_count_op_min_bytes && use_rt_kernels() )
+                return rt_kernels::popcount_op( opt, arr1, arr2, n_bytes() );
+      size_t ct = 0;
+      for( size_t c= 0; c < m_n_words; ++c )
+                         ct += count_bits( h_bitwise_op( opt, arr1[c], arr2[c] ) );
+      return ct;
+    } // count_op
+
+
+    /// Number of bits set below position idx, idx <= n_bits
+    constexpr
+    size_t
+    rank( T const *arr, size_t idx ) const noexcept
+    {
+      size_t const n_full= idx / base_t_n_bits;
+      size_t const n_rem=  idx % base_t_n_bits;
+      size_t       ct=     word_funcs( n_full * base_t_n_bits ).count( arr );
+      if( n_rem > 0 )
+        ct += count_bits( base_t( arr[n_full]
+                                  & base_t( ce_left_shift( T(1), n_rem ) - 1 ) ) );
+      return ct;
+    } // rank
+
+
+    /// \brief Index of k-th (counting from zero) bit set.
+    /// Returns npos if less than k+1 bits are set.
+    constexpr
+    size_t
+    select( T const *arr, size_t k ) const noexcept
+    {
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        auto const ct= count_bits( arr[c] );
+        if( k < ct ) return c * base_t_n_bits + select_bit_set<T>()( arr[c], k );
+        k -= ct;
+      }
+      return npos;
+    } // select
+
+
+    /// \brief Writes the indices of the set bits in ascending order
+    /// to out, at most max_n of them. Returns the number written.
+    /// The runtime kernel reads the words as bytes, hence it is only
+    /// used on little-endian targets.
+    template<class IdxT>
+    constexpr
+    size_t
+    decode_positions( T const *arr, IdxT *out, size_t max_n ) const noexcept
+    {
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+        return rt_kernels::decode_positions( arr, n_bytes(), out, max_n );
+#endif
+      return decode_positions_impl( arr, out, max_n );
+    }
+
+
+    /// Decodes word by word, used during constant evaluation
+    template<class IdxT>
+    constexpr
+    size_t
+    decode_positions_impl( T const *arr, IdxT *out, size_t max_n ) const noexcept
+    {
+      size_t n= 0;
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        for( base_t v= arr[c]; v != base_t(0) && n < max_n; v &= base_t(v-1) )
+          out[n++]= IdxT( c * base_t_n_bits + index_lsb_set<T>()( v ) );
+      }
+      return n;
+    } // decode_positions_impl
+
+
+    constexpr
+    bool
+    has_single_bit( T const *arr ) const noexcept
+    {
+      size_t ct = 0;
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        base_t x = arr[c];
+        if( x == T(0) ) continue;
+        if( loc_test_single_bit(x) ) ++ct;
+        else return false;
+        if( ct > 1 ) return false;
+      }
+      return ct == 1;
+    } // has_single_bit
+
+
+    constexpr
+    bool
+    equal( T const *arr1, T const *arr2 ) const noexcept
+    {
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+                            return rt_kernels::equal( arr1, arr2, n_bytes() );
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        if( arr1[c] != arr2[c] ) return false;
+      }
+      return true;
+    } // equal
+
+
+    /// \brief Three-way comparison in a single pass.
+    /// Returns -1, 0, or 1 if arr1 is less, equal, or greater than arr2.
+    constexpr
+    int
+    compare( T const *arr1, T const *arr2 ) const noexcept
+    {
+      size_t idx= npos;
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+      {
+        auto const i_b= rt_kernels::idx_msb_diff( arr1, arr2, n_bytes() );
+        if( i_b != n_bytes() ) idx= i_b / sizeof(base_t);
+      }
+      else
+      {
+        for( size_t c= m_n_words; c > 0; --c )
+        {
+          if( arr1[c-1] != arr2[c-1] ) { idx= c - 1; break; }
+        }
+      }
+      return   idx == npos            ?  0
+             : arr1[idx] < arr2[idx]  ? -1 : 1;
+    } // compare
+
+
+    // GCC 12 warns about arr[1] if a single word is held in a std::vector
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic push
+# pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+    /// \brief Index of least significant bit set, starting at word idx with
+    /// value v. If hgh_bit_pttrn != 2 the complement of the words gets
+    /// searched, masking the most significant word by hgh_bit_pttrn.
+    constexpr
+    size_t
+    idx_lsb_set( T const *arr, base_t v, size_t idx,
+                 base_t hgh_bit_pttrn ) const noexcept
+    {
+      bool const complement = hgh_bit_pttrn != base_t(2);
+      if( complement && idx + 1 == m_n_words )  v &= hgh_bit_pttrn;
+      while( idx < m_n_words )
+      {
+        if( v != 0 ) return idx * base_t_n_bits + index_lsb_set<base_t>()( v );
+        if( ++idx < m_n_words )
+        {
+          v = arr[idx];
+          if( complement ) {
+            v = ~v;
+            if( idx + 1 == m_n_words ) v &= hgh_bit_pttrn;
+          }
+        }
+      }
+      return npos;
+    } // idx_lsb_set
+#if defined(__GNUC__) && !defined(__clang__)
+# pragma GCC diagnostic pop
+#endif
+
+
+    /// Index of most significant bit set, see idx_lsb_set
+    constexpr
+    size_t
+    idx_msb_set( T const *arr, base_t hgh_bit_pttrn ) const noexcept
+    {
+      bool const complement = hgh_bit_pttrn != base_t(2);
+      index_msb_set<base_t>  msb_hlpr;
+      for( size_t i = m_n_words; i-- > 0; )
+      {
+        base_t val = complement ? base_t(~(arr[i])) : arr[i];
+        if( complement && i + 1 == m_n_words ) val &= hgh_bit_pttrn;
+        size_t idx = msb_hlpr( val );
+        if( idx != npos ) return i * base_t_n_bits + idx;
+      }
+      return npos;
+    } // idx_msb_set
+
+
+    /// \brief Index of next (> idx) bit set, or unset if zeros == true.
+    /// Requires idx < n_bits.
+    constexpr
+    size_t
+    find_next( T const *arr, size_t idx, bool zeros ) const noexcept
+    {
+      if( idx + 1 >= m_n_bits ) return npos;
+      size_t const arr_idx = (idx+1) / base_t_n_bits;
+      size_t const idx_mod = (idx+1) % base_t_n_bits;
+      auto const   v= zeros ? base_t(~arr[arr_idx]) : arr[arr_idx];
+      return idx_lsb_set( arr, base_t( v & ce_left_shift( all_one(), idx_mod ) ),
+                          arr_idx, zeros ? m_hgh_bit_pattern : base_t(2) );
+    } // find_next
+
+
+    /// Sets all bits
+    constexpr
+    void
+    set_all( T *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      for( size_t c= 0; c + 1 < m_n_words; ++c ) arr[c]= all_one();
+      arr[m_n_words-1]= m_hgh_bit_pattern;
+    } // set_all
+
+
+    /// \brief Sets the bits in [lo, hi). Only the words overlapping the
+    /// range are touched. Requires lo <= hi <= n_bits.
+    constexpr
+    void
+    set_range( T *arr, size_t lo, size_t hi ) const noexcept
+    {
+      if( lo >= hi ) return;
+      auto const r= h_range( lo, hi );
+      if( r.w_lo == r.w_hi ) { arr[r.w_lo] |= base_t( r.head & r.tail ); return; }
+      arr[r.w_lo] |= r.head;
+      h_fill( arr + r.w_lo + 1, r.w_hi - r.w_lo - 1, all_one() );
+      arr[r.w_hi] |= r.tail;
+    } // set_range
+
+
+    /// Clears the bits in [lo, hi), see set_range
+    constexpr
+    void
+    reset_range( T *arr, size_t lo, size_t hi ) const noexcept
+    {
+      if( lo >= hi ) return;
+      auto const r= h_range( lo, hi );
+      if( r.w_lo == r.w_hi )
+                    { arr[r.w_lo] &= base_t( ~( r.head & r.tail ) ); return; }
+      arr[r.w_lo] &= base_t( ~r.head );
+      h_fill( arr + r.w_lo + 1, r.w_hi - r.w_lo - 1, base_t(0) );
+      arr[r.w_hi] &= base_t( ~r.tail );
+    } // reset_range
+
+
+    /// Flips the bits in [lo, hi), see set_range
+    constexpr
+    void
+    flip_range( T *arr, size_t lo, size_t hi ) const noexcept
+    {
+      if( lo >= hi ) return;
+      auto const r= h_range( lo, hi );
+      if( r.w_lo == r.w_hi ) { arr[r.w_lo] ^= base_t( r.head & r.tail ); return; }
+      arr[r.w_lo] ^= r.head;
+      for( size_t c= r.w_lo + 1; c < r.w_hi; ++c ) arr[c]= base_t( ~arr[c] );
+      arr[r.w_hi] ^= r.tail;
+    } // flip_range
+
+
+    /// Number of bits set in [lo, hi), see set_range
+    constexpr
+    size_t
+    count_range( T const *arr, size_t lo, size_t hi ) const noexcept
+    {
+      if( lo >= hi ) return 0;
+      auto const r= h_range( lo, hi );
+      if( r.w_lo == r.w_hi ) return count_bits( base_t( arr[r.w_lo] & r.head & r.tail ) );
+      return   count_bits( base_t( arr[r.w_lo] & r.head ) )
+             + word_funcs( ( r.w_hi - r.w_lo - 1 ) * base_t_n_bits )
+                                                     .count( arr + r.w_lo + 1 )
+             + count_bits( base_t( arr[r.w_hi] & r.tail ) );
+    } // count_range
+
+
+    /// True if any bit in [lo, hi) is set, see set_range
+    constexpr
+    bool
+    any_in_range( T const *arr, size_t lo, size_t hi ) const noexcept
+    {
+      if( lo >= hi ) return false;
+      auto const r= h_range( lo, hi );
+      if( r.w_lo == r.w_hi ) return base_t( arr[r.w_lo] & r.head & r.tail ) != 0;
+      return    base_t( arr[r.w_lo] & r.head ) != base_t(0)
+             || base_t( arr[r.w_hi] & r.tail ) != base_t(0)
+             || !word_funcs( ( r.w_hi - r.w_lo - 1 ) * base_t_n_bits )
+                                                      .none( arr + r.w_lo + 1 );
+    } // any_in_range
+
+
+    /// Flips all bits
+    constexpr
+    void
+    flip_assgn( T *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      for( size_t c= 0; c + 1 < m_n_words; ++c ) arr[c]= base_t( ~arr[c] );
+      arr[m_n_words-1]= base_t( ~arr[m_n_words-1] & m_hgh_bit_pattern );
+    } // flip_assgn
+
+
+    /// Used for ++ operator.
+    constexpr
+    void
+    increment( T *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+
+      size_t  c= 0;
+      for( ; c + 1 < m_n_words; ++c )
+      {
+        if( ( ++arr[c] ) != base_t(0) ) return;
+      }
+      ++arr[c];
+      arr[c] &= m_hgh_bit_pattern;
+    } // increment
+
+
+    /// Used for -- operator.
+    constexpr
+    void
+    decrement( T *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+
+      size_t  c= 0;
+      for( ; c + 1 < m_n_words; ++c )
+      {
+        if( ( arr[c]-- ) != base_t(0) ) return;
+      }
+      --arr[c];
+      arr[c] &= m_hgh_bit_pattern;
+    } // decrement
+
+
+    /// arr1 += arr2 + carry, carry is either 0 or 1
+    constexpr
+    void
+    add_assgn( T *arr1, T const *arr2, base_t carry= base_t(0) ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      for( size_t  c= 0; c < m_n_words; ++c )
+      {
+        auto const sm1= base_t( arr2[c] + carry );
+        auto const sm=  base_t( arr1[c] + sm1 );
+        carry=  sm < arr1[c] || sm1 < arr2[c];
+        arr1[c]= sm;
+      }
+      arr1[m_n_words-1] &= m_hgh_bit_pattern;
+    } // add_assgn
+
+
+    /// Two's complement
+    constexpr
+    void
+    comp2_assgn( T *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      base_t  carry= base_t(1);
+      for( size_t  c= 0; c < m_n_words; ++c )
+      {
+        auto const sm= base_t( base_t(~arr[c]) + carry );
+        carry=  base_t( (carry == base_t(1)) && ( sm == 0 ) );
+        arr[c]= sm;
+      } // for c
+      arr[m_n_words-1] &= m_hgh_bit_pattern;
+    } // comp2_assgn
+
+
+    /// \brief Gathers the bits of src at the positions of the bits set in
+    /// mask into the lowest bits of dst. Each word is extracted on its
+    /// own and written at the running count of mask bits of the words
+    /// below. dst must not alias src or mask.
+    constexpr
+    void
+    extract_bits( T *dst, T const *src, T const *mask ) const noexcept
+    {
+      extract_deposit<T> const  ed;
+      for( size_t c= 0; c < m_n_words; ++c ) dst[c]= base_t(0);
+      size_t off= 0;
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        if( mask[c] == base_t(0) ) continue;
+        auto const   v=       ed.extract( src[c], mask[c] );
+        size_t const w_idx=   off / base_t_n_bits;
+        size_t const sh=      off % base_t_n_bits;
+        dst[w_idx] |= base_t( v << sh );
+        if( sh != 0 && w_idx + 1 < m_n_words )
+                      dst[w_idx+1] |= base_t( v >> ( base_t_n_bits - sh ) );
+        off += count_bits( mask[c] );
+      } // for c
+    } // extract_bits
+
+
+    /// \brief Scatters the lowest bits of src to the positions of the bits
+    /// set in mask and writes the result to dst. Each word takes as many
+    /// bits from src as its mask word has bits set, starting at the running
+    /// count of the words below. dst must not alias src.
+    constexpr
+    void
+    deposit_bits( T *dst, T const *src, T const *mask ) const noexcept
+    {
+      extract_deposit<T> const  ed;
+      size_t off= 0;
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        auto const   m=       mask[c];
+        size_t const w_idx=   off / base_t_n_bits;
+        size_t const sh=      off % base_t_n_bits;
+        auto v= base_t( src[w_idx] >> sh );
+        if( sh != 0 && w_idx + 1 < m_n_words )
+                             v |= base_t( src[w_idx+1] << ( base_t_n_bits - sh ) );
+        dst[c]= m == base_t(0) ? base_t(0) : ed.deposit( v, m );
+        off += count_bits( m );
+      } // for c
+    } // deposit_bits
+
+
+    /// \brief Writes the m bits of arr starting at bit
+    /// shft_div * base_t_n_bits + shft_mod to the lowest bits of out,
+    /// which must hold ceil( m / base_t_n_bits ) words. Each word of out
+    /// is combined from at most two words of arr. The field must lie
+    /// within the m_n_bits bits of arr.
+    constexpr
+    void
+    extract_field( T const *arr, T *out, size_t m,
+                   size_t shft_div, size_t shft_mod ) const noexcept
+    {
+      size_t const n_out=    ( m + base_t_n_bits - 1 ) / base_t_n_bits;
+      size_t const lr_shift= base_t_n_bits - shft_mod;
+      for( size_t c= 0; c < n_out; ++c )
+      {
+        auto const c2= c + shft_div;
+        base_t const v1= base_t( arr[c2] >> shft_mod );
+        base_t const v2=
+          ( shft_mod == 0 || c2 + 1 >= m_n_words ) ? base_t(0)
+                                : ce_left_shift( arr[c2+1], lr_shift );
+        out[c]= base_t( v1 | v2 );
+      } // for c
+      if( m % base_t_n_bits != 0 )
+        out[n_out-1] &= ce_right_shift( all_one(),
+                                        base_t_n_bits - m % base_t_n_bits );
+    } // extract_field
+
+
+    /// \brief Overwrites the m bits of arr starting at bit
+    /// shft_div * base_t_n_bits + shft_mod with the lowest m bits of
+    /// field, see extract_field. Each word of field changes at most two
+    /// words of arr.
+    constexpr
+    void
+    insert_field( T *arr, T const *field, size_t m,
+                  size_t shft_div, size_t shft_mod ) const noexcept
+    {
+      size_t const n_in=     ( m + base_t_n_bits - 1 ) / base_t_n_bits;
+      size_t const lr_shift= base_t_n_bits - shft_mod;
+      for( size_t c= 0; c < n_in; ++c )
+      {
+        size_t const n_left= m - c * base_t_n_bits;
+        base_t const msk=
+          n_left >= base_t_n_bits ? all_one()
+                        : ce_right_shift( all_one(), base_t_n_bits - n_left );
+        base_t const v=  base_t( field[c] & msk );
+        auto const   c2= c + shft_div;
+        arr[c2]= base_t(   ( arr[c2] & base_t( ~base_t( msk << shft_mod ) ) )
+                         | base_t( v << shft_mod ) );
+        if( shft_mod != 0 && c2 + 1 < m_n_words )
+          arr[c2+1]= base_t(   ( arr[c2+1]
+                                 & base_t( ~ce_right_shift( msk, lr_shift ) ) )
+                             | ce_right_shift( v, lr_shift ) );
+      } // for c
+    } // insert_field
+
+
+    /// Used for <<= operator.
+    constexpr
+    void
+    shift_left_assgn( T *arr, size_t n_shift ) const noexcept
+    { plan_shift_left( arr, shift_plan<T>( n_shift ) ); }
+
+
+    /// Used for >>= operator.
+    constexpr
+    void
+    shift_right_assgn( T *arr, size_t n_shift ) const noexcept
+    { plan_shift_right( arr, shift_plan<T>( n_shift ) ); }
+
+
+    /// \brief Shifts left by the amount P was made for, P is shift_plan<T>
+    /// or ct_shift_plan<T,K>. Word c of the result is funneled from words
+    /// c - div and c - div - 1, the test for mod == 0 is done once.
+    template<class P>
+    constexpr
+    void
+    plan_shift_left( T *arr, P const &p ) const noexcept
+    {
+      if( m_n_words == 0 || ( p.div == 0 && p.mod == 0 ) ) return;
+      if( p.div >= m_n_words )
+      {
+        for( size_t c= 0; c < m_n_words; ++c ) arr[c]= base_t(0);
+        return;
+      }
+
+      size_t c= m_n_words - 1;
+      if( p.mod == 0 )
+        for( ; c > p.div; --c ) arr[c]= arr[c - p.div];
+      else
+        for( ; c > p.div; --c )
+          arr[c]= base_t(   base_t( arr[c - p.div] << p.mod )
+                          | base_t( arr[c - p.div - 1] >> p.lr_shift ) );
+      arr[p.div]= base_t( arr[0] << p.mod );
+      for( c= 0; c < p.div; ++c ) arr[c]= base_t(0);
+      arr[m_n_words-1] &= m_hgh_bit_pattern;
+    } // plan_shift_left
+
+
+    /// Shifts right by the amount P was made for, see plan_shift_left
+    template<class P>
+    constexpr
+    void
+    plan_shift_right( T *arr, P const &p ) const noexcept
+    {
+      if( m_n_words == 0 || ( p.div == 0 && p.mod == 0 ) ) return;
+      if( p.div >= m_n_words )
+      {
+        for( size_t c= 0; c < m_n_words; ++c ) arr[c]= base_t(0);
+        return;
+      }
+
+      size_t const n_w= m_n_words - p.div;
+      size_t       c=   0;
+      if( p.mod == 0 )
+        for( ; c + 1 < n_w; ++c ) arr[c]= arr[c + p.div];
+      else
+        for( ; c + 1 < n_w; ++c )
+          arr[c]= base_t(   base_t( arr[c + p.div] >> p.mod )
+                          | base_t( arr[c + p.div + 1] << p.lr_shift ) );
+      arr[n_w - 1]= base_t( arr[m_n_words - 1] >> p.mod );
+      for( c= n_w; c < m_n_words; ++c ) arr[c]= base_t(0);
+    } // plan_shift_right
+
+
+    /// \brief Writes arr rotated left by n_rot bits to out.
+    /// arr and out must not overlap.
+    constexpr
+    void
+    rotate_left( T const *arr, T *out, size_t n_rot ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      size_t const rot= n_rot % m_n_bits;
+      if( rot == 0 )
+      {
+        for( size_t c= 0; c < m_n_words; ++c ) out[c]= arr[c];
+        return;
+      }
+      if( m_n_words == 1 )
+      {
+        out[0]= base_t( (   base_t( arr[0] << rot )
+                          | ce_right_shift( arr[0], m_n_bits - rot ) )
+                        & m_hgh_bit_pattern );
+        return;
+      }
+
+      size_t const rot_div =   rot / base_t_n_bits;
+      size_t const rot_mod =   rot % base_t_n_bits;
+      size_t const rot_r_div = (m_n_bits - rot) / base_t_n_bits;
+      size_t const rot_r_mod = (m_n_bits - rot) % base_t_n_bits;
+      size_t const bits_last = (m_mod_val == 0) ? base_t_n_bits : m_mod_val;
+      size_t       c = 0;
+
+      size_t const h1 = (bits_last < rot_r_mod) ? 2 : 1;
+      for( ; c + h1 + rot_r_div < m_n_words; ++c )
+      {
+        size_t i1 = c + rot_r_div;
+        size_t i2 = i1 + 1;
+        base_t v1 = ce_right_shift( arr[i1], rot_r_mod );
+        base_t v2 = ce_left_shift(  arr[i2], base_t_n_bits - rot_r_mod );
+        out[c] = base_t( v1 | v2 );
+      } // for c
+
+      if( c < m_n_words && bits_last < rot_r_mod )
+      {
+        base_t v1 = ce_right_shift( arr[m_n_words-2], rot_r_mod );
+        base_t v2 = ce_left_shift(  arr[m_n_words-1], base_t_n_bits - rot_r_mod );
+        base_t v3 = ce_left_shift( arr[0], base_t_n_bits - rot_r_mod + bits_last );
+        out[c++] = base_t( v1 | v2 | v3 );
+      }
+
+      if( c < m_n_words && bits_last > rot_r_mod )
+      {
+        base_t v1 = ce_right_shift( arr[m_n_words-1], rot_r_mod );
+        base_t v2 = ce_left_shift(  arr[0], bits_last - rot_r_mod );
+        out[c++] = base_t( v1 | v2 );
+      }
+
+      for( ; c < m_n_words; ++c )
+      {
+        size_t i1 = c - rot_div;
+        size_t i2 = i1 - 1;
+        base_t v1 = ce_left_shift(  arr[i1], rot_mod );
+        // i1 may be zero if rot_mod == 0, don't read arr[-1] then
+        base_t v2 = rot_mod == 0 ? base_t(0)
+                    : ce_right_shift( arr[i2], base_t_n_bits - rot_mod );
+        out[c] = base_t( v1 | v2 );
+      } // for c
+
+      out[m_n_words-1] &= m_hgh_bit_pattern;
+    } // rotate_left
+
+
+    /// \brief Writes arr with bits reversed to out.
+    /// arr and out must not overlap.
+    constexpr
+    void
+    reverse( T const *arr, T *out ) const noexcept
+    {
+      size_t const n_m_mod= m_mod_val == 0 ? 0 : base_t_n_bits - m_mod_val;
+      for( size_t c= 0; c < m_n_words; ++c )
+      {
+        auto const i= m_n_words - c - 1;
+        out[c]=   c + 1 == m_n_words
+                ? base_t( reverse_bits<base_t>()( arr[0] ) >> n_m_mod )
+                : reverse_bits<base_t>()(
+                    m_mod_val == 0 ? arr[i]
+                    : base_t( ( arr[i] << n_m_mod ) | ( arr[i-1] >> m_mod_val ) ) );
+      }
+    } // reverse
+
+
+    /// \brief Reverses the bits of arr in place. All words are reversed,
+    /// which moves the zeros above n_bits to the bottom, where they are
+    /// shifted out.
+    constexpr
+    void
+    reverse_assgn( T *arr ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      if( n_bytes() >= rt_kernel_min_bytes && use_rt_kernels() )
+        rt_kernels::reverse_all_bits( arr, n_bytes() );
+      else
+      {
+        reverse_bits<base_t> const rb;
+        for( size_t c= 0, i= m_n_words - 1; c < i; ++c, --i )
+        {
+          auto const v= arr[c];
+          arr[c]= rb( arr[i] );
+          arr[i]= rb( v );
+        }
+        if( m_n_words % 2 == 1 ) arr[m_n_words / 2]= rb( arr[m_n_words / 2] );
+      }
+      if( m_mod_val != 0 )
+        plan_shift_right( arr, shift_plan<T>( base_t_n_bits - m_mod_val ) );
+    } // reverse_assgn
+
+
+    /// \brief Rotates arr left by n_rot bits in place:
+    /// If the bits which wrap around in either direction fit into
+    /// rot_buf_n_words words, they are saved there and arr is shifted.
+    /// Otherwise, all words are rotated as a ring, see h_rotate_ring. If
+    /// n_bits is not a multiple of base_t_n_bits, the bits which wrapped
+    /// around are moved down by the number of unused bits in the highest
+    /// word afterwards.
+    constexpr
+    void
+    rotate_assgn( T *arr, size_t n_rot ) const noexcept
+    {
+      if( m_n_words == 0 ) return;
+      size_t const rot=   n_rot % m_n_bits;
+      size_t const r_rot= m_n_bits - rot;
+      if( rot == 0 ) return;
+
+      if( rot <= rot_buf_n_bits )
+      {
+        base_t buf[rot_buf_n_words]{};
+        extract_field( arr, buf, rot,
+                       r_rot / base_t_n_bits, r_rot % base_t_n_bits );
+        plan_shift_left( arr, shift_plan<T>( rot ) );
+        for( size_t c= 0; c < n_words_for( rot ); ++c ) arr[c] |= buf[c];
+        return;
+      }
+      if( r_rot <= rot_buf_n_bits )
+      {
+        base_t buf[rot_buf_n_words]{};
+        extract_field( arr, buf, r_rot, 0, 0 );
+        plan_shift_right( arr, shift_plan<T>( r_rot ) );
+        insert_field( arr, buf, r_rot,
+                      rot / base_t_n_bits, rot % base_t_n_bits );
+        return;
+      }
+
+      h_rotate_ring( arr, m_n_words, rot );
+      if( m_mod_val == 0 ) return;
+
+      // The first gap bits which wrapped around are above n_bits, the
+      // others start at bit 0, followed by the gap zeros from above n_bits.
+      size_t const gap= base_t_n_bits - m_mod_val;
+      base_t const top= base_t( arr[m_n_words-1] >> m_mod_val );
+      arr[m_n_words-1] &= m_hgh_bit_pattern;
+      h_shift_left_below( arr, rot, gap );
+      arr[0] |= top;
+    } // rotate_assgn
+
+
+    /// Four bits ending at bit offset, used for hex-strings
+    static
+    constexpr
+    base_t
+    get_four_bits( T const *arr, size_t offset ) noexcept
+    {
+      auto const idx=     offset / base_t_n_bits;
+      auto const bit_idx= offset % base_t_n_bits;
+      if( bit_idx >= 3 ) return base_t( ( arr[idx] >> ( bit_idx - 3 ) ) & base_t(0xF) );
+      return base_t(
+        (( arr[idx] & ( ( base_t(1) << (bit_idx+1) ) - 1 ) ) << ( 3 - bit_idx ))
+        + ( ( idx == 0 ) ? base_t(0)
+                         : base_t( arr[idx-1] >> (base_t_n_bits - (3 - bit_idx)) ) ) );
+    } // get_four_bits
+
+
+    static
+    constexpr
+    base_t
+    all_one() noexcept
+    { return base_t( ~base_t(0) ); }
+
+
+    /// \brief First and last word of a non-empty bit range and the masks
+    /// selecting the bits of the range in these words
+    struct range_t
+    {
+      size_t  w_lo;
+      size_t  w_hi;
+      base_t  head;
+      base_t  tail;
+    }; // struct range_t
+
+    static
+    constexpr
+    range_t
+    h_range( size_t lo, size_t hi ) noexcept
+    {
+      return range_t{ lo / base_t_n_bits, ( hi - 1 ) / base_t_n_bits,
+                      base_t( all_one() << ( lo % base_t_n_bits ) ),
+                      ce_right_shift( all_one(),
+                                      base_t_n_bits - 1 - ( hi - 1 ) % base_t_n_bits ) };
+    }
+
+    /// Sets n_w words to v, which is either zero or all_one()
+    static
+    constexpr
+    void
+    h_fill( T *arr, size_t n_w, base_t v ) noexcept
+    {
+      if( n_w * sizeof(base_t) >= rt_kernel_min_bytes && use_rt_kernels() )
+      {
+        std::memset( arr, v == base_t(0) ? 0 : 0xFF, n_w * sizeof(base_t) );
+        return;
+      }
+      for( size_t c= 0; c < n_w; ++c ) arr[c]= v;
+    } // h_fill
+
+    /// Reverses the order of the words [lo, hi)
+    static
+    constexpr
+    void
+    h_reverse_words( T *arr, size_t lo, size_t hi ) noexcept
+    {
+      for( ; lo + 1 < hi; ++lo, --hi )
+      {
+        auto const v= arr[lo];
+        arr[lo]=   arr[hi-1];
+        arr[hi-1]= v;
+      }
+    } // h_reverse_words
+
+    /// \brief Rotates the n_w * base_t_n_bits bits of arr left by rot bits:
+    /// The words are rotated by three reversals, then funnel shifted.
+    static
+    constexpr
+    void
+    h_rotate_ring( T *arr, size_t n_w, size_t rot ) noexcept
+    {
+      size_t const rot_div= ( rot / base_t_n_bits ) % n_w;
+      size_t const rot_mod= rot % base_t_n_bits;
+      if( rot_div != 0 )
+      {
+        h_reverse_words( arr, 0, n_w - rot_div );
+        h_reverse_words( arr, n_w - rot_div, n_w );
+        h_reverse_words( arr, 0, n_w );
+      }
+      if( rot_mod == 0 ) return;
+      size_t const lr_shift= base_t_n_bits - rot_mod;
+      base_t const carry=    base_t( arr[n_w-1] >> lr_shift );
+      for( size_t c= n_w - 1; c > 0; --c )
+        arr[c]= base_t(   base_t( arr[c] << rot_mod )
+                        | base_t( arr[c-1] >> lr_shift ) );
+      arr[0]= base_t( base_t( arr[0] << rot_mod ) | carry );
+    } // h_rotate_ring
+
+    /// \brief Shifts the bits [0, hi) left by n_shift bits, the bits from
+    /// hi on are kept. 0 < n_shift < base_t_n_bits <= hi.
+    static
+    constexpr
+    void
+    h_shift_left_below( T *arr, size_t hi, size_t n_shift ) noexcept
+    {
+      size_t const w_hi=     hi / base_t_n_bits;
+      size_t const b_hi=     hi % base_t_n_bits;
+      size_t const lr_shift= base_t_n_bits - n_shift;
+      if( b_hi != 0 )
+      {
+        base_t const msk= ce_right_shift( all_one(), base_t_n_bits - b_hi );
+        base_t const v=   base_t(   base_t( arr[w_hi] << n_shift )
+                                  | base_t( arr[w_hi-1] >> lr_shift ) );
+        arr[w_hi]= base_t( ( arr[w_hi] & base_t( ~msk ) ) | ( v & msk ) );
+      }
+      for( size_t c= w_hi - 1; c > 0; --c )
+        arr[c]= base_t(   base_t( arr[c] << n_shift )
+                        | base_t( arr[c-1] >> lr_shift ) );
+      arr[0]= base_t( arr[0] << n_shift );
+    } // h_shift_left_below
+
+    constexpr
+    size_t
+    n_bytes() const noexcept
+    { return m_n_words * sizeof(base_t); }
+
+    size_t     m_n_bits;
+    size_t     m_n_words;
+    size_t     m_mod_val;
+    base_t     m_hgh_bit_pattern;
+  }; // struct word_funcs
+
+
+} // namespace detail
+} // namespace Bitset2
+
+
+
+#undef CMPLRPOW2
+
+#endif // BITSET2_WORD_FUNCS_CB_HPP
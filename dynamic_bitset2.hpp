@@ -0,0 +1,214 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_DYNAMIC_BITSET2_CB_HPP
+#define BITSET2_DYNAMIC_BITSET2_CB_HPP
+
+
+#include "bitset2.hpp"
+#include "detail/sized_bitset_impl.hpp"
+#include <vector>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+
+
+
+namespace Bitset2
+{
+
+
+/// \brief Bitset whose number of bits is set at runtime. The words are
+/// held in a std::vector<T,Alloc>. All algorithms are shared with
+/// bitset2 (see detail::word_funcs) and the interface with bounded_bitset2
+/// (see detail::sized_bitset_impl). Bits above size() are kept zero.
+/// resize() never reallocates as long as the new size does not exceed
+/// capacity(), which can be set in advance by reserve(). Shrinking keeps
+/// the capacity. Binary operations require operands of equal size and
+/// throw std::invalid_argument otherwise.
+template<class T= unsigned long long,class Alloc= std::allocator<T> >
+class dynamic_bitset2
+: public detail::sized_bitset_impl<dynamic_bitset2<T,Alloc>,T>
+{
+  static_assert( detail::is_unsgnd_int<T>::value,
+                 "dynamic_bitset2 requires an unsigned integral base type" );
+
+  using base=     detail::sized_bitset_impl<dynamic_bitset2,T>;
+  using w_funcs=  detail::word_funcs<T>;
+  using vector_t= std::vector<T,Alloc>;
+
+  friend base;
+
+  using base::base_t_n_bits;
+
+public:
+  using typename base::base_t;
+  using typename base::ULLONG_t;
+  using allocator_type= Alloc;
+  using size_type=      size_t;
+
+
+  /* ------------------------------------------------------------- */
+  dynamic_bitset2() noexcept( noexcept( Alloc() ) )= default;
+
+  explicit
+  dynamic_bitset2( Alloc const &alloc ) noexcept
+  : m_words( alloc )
+  {}
+
+  /// n_bits bits, the lowest ones initialized from value
+  explicit
+  dynamic_bitset2( size_t n_bits, ULLONG_t value= 0,
+                   Alloc const &alloc= Alloc() )
+  : m_words( w_funcs::n_words_for( n_bits ), T(0), alloc )
+  , m_n_bits( n_bits )
+  {
+    this->assign_ullong( value );
+    this->mask_hgh_bits();
+  }
+
+  /// Copies the bits of bs
+  template<size_t N>
+  explicit
+  dynamic_bitset2( bitset2<N,T> const &bs, Alloc const &alloc= Alloc() )
+  : m_words( bs.data().begin(),
+             bs.data().begin() + w_funcs::n_words_for( N ), alloc )
+  , m_n_bits( N )
+  {}
+
+  template< class CharT, class Traits, class SAlloc >
+  explicit
+  dynamic_bitset2( std::basic_string<CharT,Traits,SAlloc> const
+                                                    & str,
+                   typename std::basic_string<CharT,Traits,SAlloc>::size_type
+                                                    pos = 0,
+                   typename std::basic_string<CharT,Traits,SAlloc>::size_type
+                                                    n = std::basic_string<CharT,Traits,SAlloc>::npos,
+                   CharT                            zero= CharT('0'),
+                   CharT                            one=  CharT('1'),
+                   Alloc const                      &alloc= Alloc() )
+  : m_words( alloc )
+  {
+    resize( base::string_n_bits( str, pos, n ) );
+    this->assign_string( str, pos, zero, one );
+  }
+
+  template< class CharT >
+  explicit
+  dynamic_bitset2( const CharT        *str,
+                   typename std::basic_string<CharT>::size_type
+                                      n=     std::basic_string<CharT>::npos,
+                   CharT              zero=  CharT('0'),
+                   CharT              one=   CharT('1') )
+  : dynamic_bitset2( n == std::basic_string<CharT>::npos
+                     ? std::basic_string<CharT>( str )
+                     : std::basic_string<CharT>( str, n ),
+                     0, n, zero, one )
+  {}
+  /* ------------------------------------------------------------- */
+
+
+  //** Size and storage
+
+  size_t size()  const noexcept { return m_n_bits; }
+  bool   empty() const noexcept { return m_n_bits == 0; }
+
+  /// Number of bits which fit into the allocated storage
+  size_t
+  capacity() const noexcept
+  { return m_words.capacity() * base_t_n_bits; }
+
+  /// Allocates storage for n_bits bits, such that resize does not reallocate
+  void
+  reserve( size_t n_bits )
+  { m_words.reserve( w_funcs::n_words_for( n_bits ) ); }
+
+  void
+  shrink_to_fit()
+  { m_words.shrink_to_fit(); }
+
+  /// \brief Changes size to n_bits. Added bits are set to value.
+  /// Does not reallocate if n_bits <= capacity().
+  void
+  resize( size_t n_bits, bool value= false )
+  {
+    auto const old_n_bits= m_n_bits;
+    m_words.resize( w_funcs::n_words_for( n_bits ),
+                    value ? w_funcs::all_one() : T(0) );
+    m_n_bits= n_bits;
+    if( value && n_bits > old_n_bits && old_n_bits % base_t_n_bits != 0 )
+      m_words[old_n_bits / base_t_n_bits] |=
+                  detail::ce_left_shift( w_funcs::all_one(),
+                                         old_n_bits % base_t_n_bits );
+    this->mask_hgh_bits();
+  } // resize
+
+  /// Appends a bit as new most significant bit
+  void
+  push_back( bool value )
+  {
+    if( m_n_bits % base_t_n_bits == 0 ) m_words.push_back( T(0) );
+    ++m_n_bits;
+    this->set_noexcept( m_n_bits - 1, value );
+  }
+
+  /// Sets size to zero, keeps capacity
+  void
+  clear() noexcept
+  {
+    m_words.clear();
+    m_n_bits= 0;
+  }
+
+  allocator_type
+  get_allocator() const
+  { return m_words.get_allocator(); }
+
+  /// Pointer to the words, the least significant one first
+  base_t const *
+  data() const noexcept
+  { return m_words.data(); }
+
+  /// Number of words pointed to by data()
+  size_t
+  n_words() const noexcept
+  { return m_words.size(); }
+
+  /// Converts to bitset2<N,T>. Throws invalid_argument if size() != N.
+  template<size_t N>
+  bitset2<N,T>
+  to_bitset2() const
+  {
+    if( m_n_bits != N )
+      throw std::invalid_argument( "dynamic_bitset2: to_bitset2 size mismatch" );
+    typename bitset2<N,T>::array_t arr{};
+    std::copy( m_words.begin(), m_words.end(), arr.begin() );
+    return bitset2<N,T>( arr );
+  }
+
+private:
+  T       *word_ptr()       noexcept { return m_words.data(); }
+  T const *word_ptr() const noexcept { return m_words.data(); }
+
+  vector_t   m_words;
+  size_t     m_n_bits= 0;
+}; // class dynamic_bitset2
+
+
+} // namespace Bitset2
+
+
+#endif // BITSET2_DYNAMIC_BITSET2_CB_HPP
@@ -0,0 +1,179 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_HAMMING_INDEX_CB_HPP
+#define BITSET2_HAMMING_INDEX_CB_HPP
+
+
+#include "bitset2.hpp"
+#include "hamming_topk.hpp"
+#include <vector>
+#include <array>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+
+
+
+namespace Bitset2
+{
+
+
+/// \brief Multi-index hash table for searching all bitset2s within a given
+/// Hamming radius of a query, see M. Norouzi, A. Punjani, D. J. Fleet:
+/// Fast Search in Hamming Space with Multi-Index Hashing, CVPR 2012.
+/// Each bitset2 is split into M substrings of N / M or N / M + 1 bits,
+/// each substring is the key into its own hash table. If two bitset2s
+/// differ in at most r bits, then by the pigeonhole principle at least one
+/// of their substrings differs in at most r/M bits. Hence a search
+/// enumerates the neighbourhoods of the query's substrings and verifies
+/// the candidates found. Choose sub_n_bits close to log2 of the number
+/// of elements.
+template<size_t N,
+         size_t M= ( N + 15 ) / 16,
+         class T= detail::select_base_t<N> >
+class hamming_index
+{
+public:
+  using bitset_t= bitset2<N,T>;
+
+  enum : size_t { n_substr=   M
+                , sub_n_bits= ( N + M - 1 ) / M   ///< longest substring
+                , n_long=     N % M };            ///< # substrings of sub_n_bits
+
+  static_assert( M > 0 && M <= N, "Number of substrings must be in [1,N]" );
+  static_assert( sub_n_bits <= 64, "Substrings must not exceed 64 bits" );
+
+private:
+  using key_t=   uint64_t;
+  using table_t= std::unordered_map<key_t,std::vector<size_t> >;
+
+public:
+  hamming_index()= default;
+
+  template<class InputIt>
+  hamming_index( InputIt first, InputIt last )
+  { for( ; first != last; ++first ) insert( *first ); }
+
+  /// Adds bs, returns its index
+  size_t
+  insert( bitset_t const &bs )
+  {
+    auto const idx= m_items.size();
+    m_items.push_back( bs );
+    for( size_t j= 0; j < M; ++j ) m_tables[j][substr( bs, j )].push_back( idx );
+    return idx;
+  } // insert
+
+  size_t
+  size() const noexcept
+  { return m_items.size(); }
+
+  bitset_t const &
+  operator[]( size_t idx ) const noexcept
+  { return m_items[idx]; }
+
+  /// \brief Returns all elements within Hamming distance r of query,
+  /// ordered by distance and then index.
+  std::vector<hamming_hit>
+  search( bitset_t const &query, size_t r ) const
+  {
+    std::vector<hamming_hit> ret_val;
+    // r = a * M + b: Some substring j <= b differs in at most a bits
+    // or some substring j > b in at most a - 1 bits.
+    auto const a= r / M;
+    auto const b= r % M;
+    for( size_t j= 0; j < M; ++j )
+    {
+      if( j > b && a == 0 ) break;
+      auto const rad= ( j <= b ) ? a : a - 1;
+      auto const &tbl= m_tables[j];
+      auto const  key= substr( query, j );
+      for_each_neighbour( key, sub_len( j ), rad, [&]( key_t nb )
+      {
+        auto const it= tbl.find( nb );
+        if( it == tbl.end() ) return;
+        for( auto const idx: it->second )
+        {
+          auto const dist= count_xor( query, m_items[idx] );
+          if( dist <= r ) ret_val.push_back( hamming_hit{ idx, dist } );
+        }
+      } );
+    }
+    std::sort( ret_val.begin(), ret_val.end() );
+    ret_val.erase( std::unique( ret_val.begin(), ret_val.end() ),
+                   ret_val.end() );
+    return ret_val;
+  } // search
+
+private:
+  /// \brief Number of bits in substring j: The first n_long substrings
+  /// have N / M + 1 bits, the others N / M.
+  static
+  constexpr
+  size_t
+  sub_len( size_t j ) noexcept
+  { return N / M + ( j < n_long ? 1 : 0 ); }
+
+  /// Index of the lowest bit of substring j
+  static
+  constexpr
+  size_t
+  sub_offset( size_t j ) noexcept
+  { return j * ( N / M ) + std::min( j, size_t( n_long ) ); }
+
+  /// Substring j of bs
+  static
+  key_t
+  substr( bitset_t const &bs, size_t j ) noexcept
+  {
+    auto const key= key_t( convert_to<sub_n_bits>( bs >> sub_offset( j ) ).to_ullong() );
+    auto const len= sub_len( j );
+    return ( len == 64 ) ? key : key_t( key & ( ( key_t(1) << len ) - 1 ) );
+  } // substr
+
+  /// \brief Calls f for each key differing from key in at most rad of
+  /// the n_bits lowest bits. Masks of equal weight are enumerated by
+  /// Gosper's hack.
+  template<class F>
+  static
+  void
+  for_each_neighbour( key_t key, size_t n_bits, size_t rad, F f )
+  {
+    f( key );
+    rad= std::min( rad, n_bits );
+    auto const lim= ( n_bits == 64 ) ? key_t(0) : key_t(1) << n_bits;
+    for( size_t d= 1; d <= rad; ++d )
+    {
+      key_t msk= ( d == 64 ) ? ~key_t(0) : ( key_t(1) << d ) - 1;
+      for( ;; )
+      {
+        f( key ^ msk );
+        // Next larger mask with d bits set
+        auto const lo=  msk & ( ~msk + 1 );
+        auto const rpl= msk + lo;
+        if( rpl == 0 || ( lim != 0 && rpl >= lim ) ) break;
+        msk= ( ( ( rpl ^ msk ) >> 2 ) / lo ) | rpl;
+      }
+    }
+  } // for_each_neighbour
+
+  std::vector<bitset_t>    m_items;
+  std::array<table_t,M>    m_tables;
+}; // class hamming_index
+
+
+} // namespace Bitset2
+
+
+#endif // BITSET2_HAMMING_INDEX_CB_HPP
@@ -0,0 +1,202 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_HAMMING_TOPK_CB_HPP
+#define BITSET2_HAMMING_TOPK_CB_HPP
+
+
+#include "bitset2.hpp"
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <exception>
+#include <cstddef>
+
+#if __cplusplus >= 202002L
+# include <version>
+# ifdef __cpp_lib_span
+#  include <span>
+#  include <type_traits>
+#  define CMPLRSPAN
+# endif
+#endif
+
+
+
+namespace Bitset2
+{
+
+
+/// Position of a bitset2 in the database and its distance to the query
+struct hamming_hit
+{
+  size_t  index;
+  size_t  distance;
+
+  friend
+  constexpr
+  bool
+  operator<( hamming_hit const &h1, hamming_hit const &h2 ) noexcept
+  {
+    return    h1.distance < h2.distance
+           || ( h1.distance == h2.distance && h1.index < h2.index );
+  }
+
+  friend
+  constexpr
+  bool
+  operator==( hamming_hit const &h1, hamming_hit const &h2 ) noexcept
+  { return h1.distance == h2.distance && h1.index == h2.index; }
+}; // struct hamming_hit
+
+
+namespace detail
+{
+  /// \brief Scans db[first,last) and keeps the k nearest in heap, a max
+  /// heap w.r.t. operator< of hamming_hit. Distances are computed by
+  /// count_xor, no temporaries are built.
+  template<size_t N,class T>
+  void
+  hamming_scan( bitset2<N,T> const &query, bitset2<N,T> const *db,
+                size_t first, size_t last, size_t k,
+                std::vector<hamming_hit> &heap )
+  {
+    if( k == 0 || first >= last ) return;
+    heap.reserve( std::min( k, last - first ) );
+    size_t c= first;
+    for( ; c < last && heap.size() < k; ++c )
+    {
+      heap.push_back( hamming_hit{ c, count_xor( query, db[c] ) } );
+      std::push_heap( heap.begin(), heap.end() );
+    }
+    // Indices increase, so equal distances do not replace the top
+    auto worst= heap.empty() ? size_t(0) : heap.front().distance;
+    for( ; c < last; ++c )
+    {
+      auto const dist= count_xor( query, db[c] );
+      if( dist >= worst ) continue;
+      std::pop_heap( heap.begin(), heap.end() );
+      heap.back()= hamming_hit{ c, dist };
+      std::push_heap( heap.begin(), heap.end() );
+      worst= heap.front().distance;
+    }
+  } // hamming_scan
+
+
+  /// \brief Joins all joinable threads on destruction, such that no
+  /// joinable std::thread gets destroyed if an exception is thrown.
+  struct thread_joiner
+  {
+    std::vector<std::thread>  &m_threads;
+
+    ~thread_joiner()
+    { for( auto &th: m_threads ) if( th.joinable() ) th.join(); }
+  }; // struct thread_joiner
+} // namespace detail
+
+
+/// \brief Returns the k elements of db[0,n_db) with the smallest Hamming
+/// distance to query, ordered by distance and then index.
+/// Returns less than k hits if n_db < k.
+template<size_t N,class T>
+std::vector<hamming_hit>
+hamming_topk( bitset2<N,T> const &query,
+              bitset2<N,T> const *db, size_t n_db, size_t k )
+{
+  std::vector<hamming_hit> ret_val;
+  detail::hamming_scan( query, db, 0, n_db, k, ret_val );
+  std::sort_heap( ret_val.begin(), ret_val.end() );
+  return ret_val;
+} // hamming_topk
+
+
+/// \brief Same as hamming_topk, but db gets split into n_threads
+/// parts, which are scanned concurrently. n_threads == 0 means
+/// std::thread::hardware_concurrency(). The threads are created per
+/// call, there is no pool. An exception thrown while scanning any part
+/// is rethrown after all threads have been joined.
+template<size_t N,class T>
+std::vector<hamming_hit>
+hamming_topk_mt( bitset2<N,T> const &query,
+                 bitset2<N,T> const *db, size_t n_db, size_t k,
+                 size_t n_threads= 0 )
+{
+  if( n_threads == 0 )
+         n_threads= std::max( size_t(1),
+                              size_t( std::thread::hardware_concurrency() ) );
+  // Not worth a thread for less than 4096 elements
+  n_threads= std::max( size_t(1), std::min( n_threads, n_db / 4096 ) );
+  if( n_threads == 1 ) return hamming_topk( query, db, n_db, k );
+
+  std::vector<std::vector<hamming_hit> >  heaps( n_threads );
+  std::vector<std::exception_ptr>         errors( n_threads );
+  std::vector<std::thread>                threads;
+  threads.reserve( n_threads - 1 );
+  auto const chunk= ( n_db + n_threads - 1 ) / n_threads;
+  {
+    detail::thread_joiner const  joiner{ threads };
+    for( size_t t= 1; t < n_threads; ++t )
+    {
+      auto const first= std::min( n_db, t * chunk );
+      auto const last=  std::min( n_db, first + chunk );
+      threads.emplace_back( [&query,db,first,last,k,&heaps,&errors,t]()
+      {
+        try { detail::hamming_scan( query, db, first, last, k, heaps[t] ); }
+        catch( ... ) { errors[t]= std::current_exception(); }
+      } );
+    }
+    detail::hamming_scan( query, db, 0, std::min( n_db, chunk ), k, heaps[0] );
+  } // joins
+  for( auto const &e: errors ) if( e ) std::rethrow_exception( e );
+
+  std::vector<hamming_hit> ret_val;
+  size_t n_hits= 0;
+  for( auto const &h: heaps ) n_hits += h.size();
+  ret_val.reserve( n_hits );
+  for( auto const &h: heaps ) ret_val.insert( ret_val.end(), h.begin(), h.end() );
+  auto const n_ret= std::min( k, ret_val.size() );
+  std::partial_sort( ret_val.begin(), ret_val.begin() + n_ret, ret_val.end() );
+  ret_val.resize( n_ret );
+  return ret_val;
+} // hamming_topk_mt
+
+
+#ifdef CMPLRSPAN
+/// \brief Returns the k elements of db nearest to query, see above.
+/// N and T are deduced from query only, such that db may be anything
+/// convertible to the span, e.g. std::span( vec ) or a std::vector.
+template<size_t N,class T>
+std::vector<hamming_hit>
+hamming_topk( bitset2<N,T> const &query,
+              std::type_identity_t<std::span<bitset2<N,T> const> > db,
+              size_t k )
+{ return hamming_topk( query, db.data(), db.size(), k ); }
+
+
+/// Multithreaded version of hamming_topk, see above
+template<size_t N,class T>
+std::vector<hamming_hit>
+hamming_topk_mt( bitset2<N,T> const &query,
+                 std::type_identity_t<std::span<bitset2<N,T> const> > db,
+                 size_t k,
+                 size_t n_threads= 0 )
+{ return hamming_topk_mt( query, db.data(), db.size(), k, n_threads ); }
+#endif
+
+
+} // namespace Bitset2
+
+
+#undef CMPLRSPAN
+
+#endif // BITSET2_HAMMING_TOPK_CB_HPP
@@ -0,0 +1,343 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_LAZY_BITSET2_CB_HPP
+#define BITSET2_LAZY_BITSET2_CB_HPP
+
+
+#include "bitset2.hpp"
+#include "detail/word_funcs.hpp"
+#include "detail/count_bits.hpp"
+#include <type_traits>
+#include <utility>
+
+
+
+namespace Bitset2
+{
+namespace detail
+{
+
+
+/// \brief Base of the lazy expression types, see lazy(). E derives from
+/// it and provides word( idx ), which computes word idx of the result
+/// from the words idx of the operands. Bits above N may be set in the
+/// highest word, they are masked out here.
+template<class E,size_t N,class T>
+class lazy_expr
+{
+public:
+  using lazy_expr_tag= void;
+  using base_t=        T;
+
+  enum : size_t { n_bits=  N
+                , n_array= bit_chars<N,T>::n_array };
+
+  constexpr size_t size() const noexcept { return N; }
+
+  /// Number of bits set, computed in one pass over the operands
+  constexpr
+  size_t
+  count() const noexcept
+  {
+    size_t ct= 0;
+    for( size_t c= 0; c + 1 < n_array; ++c ) ct += count_bits( self().word( c ) );
+    return ct + count_bits( masked_word( n_array - 1 ) );
+  }
+
+  /// Stops after the first block of words with a bit set
+  constexpr
+  bool
+  any() const noexcept
+  {
+    size_t c= 0;
+    for( ; c + block_n_words < n_array; c += block_n_words )
+    {
+      base_t acc= base_t(0);
+      for( size_t w= 0; w < block_n_words; ++w ) acc |= self().word( c + w );
+      if( acc != base_t(0) ) return true;
+    }
+    base_t acc= base_t(0);
+    for( ; c < n_array; ++c ) acc |= masked_word( c );
+    return acc != base_t(0);
+  }
+
+  constexpr bool none() const noexcept { return !any(); }
+
+  /// Stops after the first block of words with a bit not set
+  constexpr
+  bool
+  all() const noexcept
+  {
+    size_t c= 0;
+    for( ; c + block_n_words < n_array; c += block_n_words )
+    {
+      base_t acc= all_one;
+      for( size_t w= 0; w < block_n_words; ++w ) acc &= self().word( c + w );
+      if( acc != all_one ) return false;
+    }
+    for( ; c + 1 < n_array; ++c ) if( self().word( c ) != all_one ) return false;
+    return masked_word( n_array - 1 ) == hgh_bit_pattern;
+  }
+
+  /// Evaluates the expression in one pass into a bitset2 with storage S
+  template<class S= inline_storage>
+  constexpr
+  bitset2<N,T,S>
+  eval() const noexcept( is_inline_storage<S>::value )
+  {
+    return bitset2<N,T,S>( gen_tag{}, [this]{
+      typename bitset2<N,T,S>::array_t  ret_val{};
+      for( size_t c= 0; c + 1 < n_array; ++c ) ret_val[c]= self().word( c );
+      ret_val[n_array - 1]= masked_word( n_array - 1 );
+      return ret_val; } );
+  }
+
+  /// Allows for bitset2<N,T,S> bs= expr; and bs= expr;
+  template<class S>
+  constexpr
+  operator bitset2<N,T,S>() const noexcept( is_inline_storage<S>::value )
+  { return eval<S>(); }
+
+private:
+  enum : size_t { block_n_words= 8 };
+  enum : base_t { all_one=         bit_chars<N,T>::all_one
+                , hgh_bit_pattern= bit_chars<N,T>::hgh_bit_pattern };
+
+  constexpr E const & self() const noexcept
+  { return static_cast<E const &>( *this ); }
+
+  constexpr
+  base_t
+  masked_word( size_t idx ) const noexcept
+  {
+    return idx + 1 == n_array ? base_t( self().word( idx ) & hgh_bit_pattern )
+                              : self().word( idx );
+  }
+}; // class lazy_expr
+
+
+
+/// Refers to the words of a bitset2
+template<size_t N,class T,class S>
+class lazy_leaf : public lazy_expr<lazy_leaf<N,T,S>,N,T>
+{
+public:
+  explicit
+  constexpr
+  lazy_leaf( bitset2<N,T,S> const &bs ) noexcept
+  : m_arr( &bs.data() )
+  {}
+
+  constexpr T word( size_t idx ) const noexcept { return (*m_arr)[idx]; }
+
+private:
+  typename bitset2<N,T,S>::array_t const  *m_arr;
+}; // class lazy_leaf
+
+
+/// E1 opt E2, the operands are held by value
+template<bitwise_op_type opt,class E1,class E2>
+class lazy_binary
+: public lazy_expr<lazy_binary<opt,E1,E2>,E1::n_bits,typename E1::base_t>
+{
+public:
+  using base_t= typename E1::base_t;
+
+  static_assert( size_t(E1::n_bits) == size_t(E2::n_bits)
+                 && std::is_same<base_t,typename E2::base_t>::value,
+                 "lazy_binary: Operands must have equal N and T" );
+
+  constexpr
+  lazy_binary( E1 const &e1, E2 const &e2 ) noexcept
+  : m_e1( e1 ), m_e2( e2 )
+  {}
+
+  constexpr
+  base_t
+  word( size_t idx ) const noexcept
+  {
+    return word_funcs<base_t>::h_bitwise_op( opt, m_e1.word( idx ),
+                                                  m_e2.word( idx ) );
+  }
+
+private:
+  E1  m_e1;
+  E2  m_e2;
+}; // class lazy_binary
+
+
+/// ~E, sets the bits above N, which lazy_expr masks out
+template<class E>
+class lazy_not : public lazy_expr<lazy_not<E>,E::n_bits,typename E::base_t>
+{
+public:
+  using base_t= typename E::base_t;
+
+  explicit
+  constexpr
+  lazy_not( E const &e ) noexcept
+  : m_e( e )
+  {}
+
+  constexpr base_t word( size_t idx ) const noexcept
+  { return base_t( ~m_e.word( idx ) ); }
+
+private:
+  E  m_e;
+}; // class lazy_not
+
+
+
+/// True if E is derived from lazy_expr
+template<class E,class Enabled=void>
+struct is_lazy_expr : std::false_type {};
+
+template<class E>
+struct is_lazy_expr<E,typename E::lazy_expr_tag> : std::true_type {};
+
+
+template<class B>
+struct is_bitset2 : std::false_type {};
+
+template<size_t N,class T,class S>
+struct is_bitset2<bitset2<N,T,S> > : std::true_type {};
+
+
+/// \brief True if X1 op X2 builds a lazy expression: Both are lazy
+/// expressions or bitset2's and at least one is a lazy expression.
+template<class X1,class X2,
+         class D1= std::decay_t<X1>,class D2= std::decay_t<X2> >
+struct lazy_operands
+: std::integral_constant<bool,
+       ( is_lazy_expr<D1>::value || is_lazy_expr<D2>::value )
+    && ( is_lazy_expr<D1>::value || is_bitset2<D1>::value )
+    && ( is_lazy_expr<D2>::value || is_bitset2<D2>::value )>
+{};
+
+
+template<class E>
+constexpr
+E const &
+as_lazy( E const &e, std::true_type ) noexcept
+{ return e; }
+
+template<size_t N,class T,class S>
+constexpr
+lazy_leaf<N,T,S>
+as_lazy( bitset2<N,T,S> const &bs, std::false_type ) noexcept
+{ return lazy_leaf<N,T,S>( bs ); }
+
+
+template<bitwise_op_type opt,class X1,class X2>
+constexpr
+auto
+make_lazy_binary( X1 &&x1, X2 &&x2 ) noexcept
+{
+  using D1= std::decay_t<X1>;
+  using D2= std::decay_t<X2>;
+  static_assert(    ( is_lazy_expr<D1>::value || std::is_lvalue_reference<X1>::value )
+                 && ( is_lazy_expr<D2>::value || std::is_lvalue_reference<X2>::value ),
+                 "lazy expressions refer to their bitset2 operands, "
+                 "which must not be temporaries" );
+  auto const e1= as_lazy( x1, is_lazy_expr<D1>{} );
+  auto const e2= as_lazy( x2, is_lazy_expr<D2>{} );
+  return lazy_binary<opt,std::decay_t<decltype(e1)>,
+                         std::decay_t<decltype(e2)> >( e1, e2 );
+} // make_lazy_binary
+
+
+} // namespace detail
+
+
+
+/// \brief Opt-in to lazy evaluation: Bitwise operators &, |, ^, ~ and
+/// difference on the result build an expression object instead of
+/// computing a bitset2 for each operator, e.g.
+///   auto const la= lazy( a ), lb= lazy( b ), lc= lazy( c ), ld= lazy( d );
+///   size_t const ct= ( ( la & lb ) | ( lc & ~ld ) ).count();
+///   bitset2<N> const r= ( la & lb ) | ( lc & ~ld );
+/// The expression is evaluated word by word in one pass when converted
+/// to a bitset2 (or by eval()) or when count(), any(), none() or all()
+/// is called. any(), none() and all() return as soon as the result is
+/// known. Operands of a binary operator can be lazy expressions or
+/// bitset2's, at least one of them needs to be a lazy expression.
+/// Expressions refer to their bitset2 operands, which must outlive them.
+/// Therefore, temporary bitset2's are rejected.
+template<size_t N,class T,class S>
+constexpr
+detail::lazy_leaf<N,T,S>
+lazy( bitset2<N,T,S> const &bs ) noexcept
+{ return detail::lazy_leaf<N,T,S>( bs ); }
+
+template<size_t N,class T,class S>
+void lazy( bitset2<N,T,S> const && )= delete;
+
+
+template<class X1,class X2,
+         typename std::enable_if<detail::lazy_operands<X1,X2>::value>::type* = nullptr>
+constexpr
+auto
+operator|( X1 &&x1, X2 &&x2 ) noexcept
+{
+  return detail::make_lazy_binary<detail::bitwise_op_type::or_op>(
+                                std::forward<X1>( x1 ), std::forward<X2>( x2 ) );
+}
+
+
+template<class X1,class X2,
+         typename std::enable_if<detail::lazy_operands<X1,X2>::value>::type* = nullptr>
+constexpr
+auto
+operator&( X1 &&x1, X2 &&x2 ) noexcept
+{
+  return detail::make_lazy_binary<detail::bitwise_op_type::and_op>(
+                                std::forward<X1>( x1 ), std::forward<X2>( x2 ) );
+}
+
+
+template<class X1,class X2,
+         typename std::enable_if<detail::lazy_operands<X1,X2>::value>::type* = nullptr>
+constexpr
+auto
+operator^( X1 &&x1, X2 &&x2 ) noexcept
+{
+  return detail::make_lazy_binary<detail::bitwise_op_type::xor_op>(
+                                std::forward<X1>( x1 ), std::forward<X2>( x2 ) );
+}
+
+
+/// Lazy set difference, i.e. x1 & ~x2
+template<class X1,class X2,
+         typename std::enable_if<detail::lazy_operands<X1,X2>::value>::type* = nullptr>
+constexpr
+auto
+difference( X1 &&x1, X2 &&x2 ) noexcept
+{
+  return detail::make_lazy_binary<detail::bitwise_op_type::sdiff_op>(
+                                std::forward<X1>( x1 ), std::forward<X2>( x2 ) );
+}
+
+
+template<class E,size_t N,class T>
+constexpr
+detail::lazy_not<E>
+operator~( detail::lazy_expr<E,N,T> const &e ) noexcept
+{ return detail::lazy_not<E>( static_cast<E const &>( e ) ); }
+
+
+} // namespace Bitset2
+
+
+
+#endif // BITSET2_LAZY_BITSET2_CB_HPP
@@ -0,0 +1,187 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#ifndef BITSET2_RANK_SELECT_INDEX_CB_HPP
+#define BITSET2_RANK_SELECT_INDEX_CB_HPP
+
+
+#include "bitset2.hpp"
+#include "detail/count_bits.hpp"
+#include "detail/select_bit_set.hpp"
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+
+
+
+namespace Bitset2
+{
+
+
+/// \brief Precomputed rank directory for a bitset2<N,T>, such that
+/// rank and select do not scan the bitset from the beginning.
+/// The layout follows rank9 (Vigna, "Broadword Implementation of
+/// Rank/Select Queries"): For each block of 512 bits the number of bits
+/// set before the block and, packed into nine bits each, the counts
+/// relative to the block start of its seven trailing 64 bit words.
+/// rank is O(1). select uses samples of every 512th bit set to narrow
+/// down the blocks to search. The index refers to the bitset2 passed to
+/// the constructor. It needs to be rebuilt when the bitset2 changes and
+/// the bitset2 needs to outlive the index.
+template<size_t N,class T= detail::select_base_t<N> >
+class rank_select_index
+{
+public:
+  using bitset_t= bitset2<N,T>;
+  using array_t=  typename bitset_t::array_t;
+
+  enum : size_t { npos= bitset_t::npos };
+
+private:
+  using base_t= T;
+  using u64_t=  uint64_t;
+
+  enum : size_t
+  { base_t_n_bits=    detail::h_types<T>::base_t_n_bits
+  , n_array=          bitset_t::n_array
+  , n_words=          ( N + 63 ) / 64  ///< #64 bit words
+  , block_n_words=    8
+  , n_blocks=         n_words / block_n_words + 1
+  , sample_rate=      512              ///< Sample every 512th bit set
+  , n_samples=        N / sample_rate + 1
+  };
+
+public:
+  explicit
+  constexpr
+  rank_select_index( bitset_t const &bs ) noexcept
+  : m_data( &bs.data() )
+  {
+    size_t ct= 0;
+    for( size_t b= 0; b < n_blocks; ++b )
+    {
+      m_counts[2*b]= ct;
+      u64_t  rel= 0;
+      size_t ct_b= 0;
+      for( size_t w= 0; w < block_n_words; ++w )
+      {
+        auto const idx= b * block_n_words + w;
+        if( w > 0 ) rel |= u64_t( ct_b ) << ( 9 * ( w - 1 ) );
+        if( idx < n_words )
+        {
+          auto const v= get_word( idx );
+          auto const n_v= detail::count_bits( v );
+          // Samples point to the block containing the bit
+          for( size_t s= ( ct + sample_rate - 1 ) / sample_rate;
+               s * sample_rate < ct + n_v; ++s )
+            m_samples[s]= b;
+          ct   += n_v;
+          ct_b += n_v;
+        }
+      }
+      m_counts[2*b+1]= rel;
+    }
+    m_n_set= ct;
+    for( size_t s= ( ct + sample_rate - 1 ) / sample_rate; s < n_samples; ++s )
+      m_samples[s]= n_blocks - 1;
+  } // rank_select_index
+
+  /// Number of bits set
+  constexpr
+  size_t
+  count() const noexcept
+  { return m_n_set; }
+
+  /// \brief Returns number of bits set below position idx.
+  /// Throws out_of_range if idx > N.
+  constexpr
+  size_t
+  rank( size_t idx ) const
+  {
+    if( idx > N )
+      throw std::out_of_range( "rank_select_index: rank index out of range" );
+    if( idx == N ) return m_n_set;
+    auto const w=   idx / 64;
+    auto const b=   w / block_n_words;
+    auto const sub= w % block_n_words;
+    auto const rel= sub == 0 ? size_t(0)
+                    : size_t( ( m_counts[2*b+1] >> ( 9 * ( sub - 1 ) ) )
+                              & 0x1FF );
+    auto const rem= idx % 64;
+    auto const v=   rem == 0 ? u64_t(0)
+                    : u64_t( get_word( w ) & ( ( u64_t(1) << rem ) - 1 ) );
+    return m_counts[2*b] + rel + detail::count_bits( v );
+  } // rank
+
+  /// \brief Returns index of k-th (counting from zero) bit set.
+  /// Returns npos if less than k+1 bits are set.
+  constexpr
+  size_t
+  select( size_t k ) const noexcept
+  {
+    if( k >= m_n_set ) return npos;
+    // Last block starting with at most k bits set before it
+    size_t lo= m_samples[k / sample_rate];
+    size_t hi= k / sample_rate + 1 < n_samples
+               ? m_samples[k / sample_rate + 1] : n_blocks - 1;
+    while( lo < hi )
+    {
+      auto const mid= ( lo + hi + 1 ) / 2;
+      if( m_counts[2*mid] <= k ) lo= mid;
+      else                       hi= mid - 1;
+    }
+    k -= m_counts[2*lo];
+    auto const rel= m_counts[2*lo+1];
+    size_t     sub= 0;
+    for( ; sub + 1 < block_n_words; ++sub )
+    {
+      if( ( ( rel >> ( 9 * sub ) ) & 0x1FF ) > k ) break;
+    }
+    if( sub > 0 ) k -= size_t( ( rel >> ( 9 * ( sub - 1 ) ) ) & 0x1FF );
+    auto const w= lo * block_n_words + sub;
+    return w * 64 + detail::select_bit_set<u64_t>()( get_word( w ), k );
+  } // select
+
+private:
+  /// 64 bit word number idx of the bitset
+  constexpr
+  u64_t
+  get_word( size_t idx ) const noexcept
+  {
+    auto const &arr= *m_data;
+    if constexpr( base_t_n_bits >= 64 )
+    {
+      return u64_t( arr[idx * 64 / base_t_n_bits]
+                    >> ( idx * 64 % base_t_n_bits ) );
+    }
+    else
+    {
+      constexpr size_t per_word= 64 / base_t_n_bits;
+      u64_t ret_val= 0;
+      for( size_t c= 0; c < per_word && idx * per_word + c < n_array; ++c )
+        ret_val |= u64_t( arr[idx * per_word + c] ) << ( c * base_t_n_bits );
+      return ret_val;
+    }
+  } // get_word
+
+  array_t const                   *m_data;
+  size_t                          m_n_set= 0;
+  std::array<u64_t,2*n_blocks>    m_counts{};
+  std::array<size_t,n_samples>    m_samples{};
+}; // class rank_select_index
+
+
+} // namespace Bitset2
+
+
+#endif // BITSET2_RANK_SELECT_INDEX_CB_HPP
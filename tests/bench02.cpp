@@ -0,0 +1,147 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+
+
+// Compares count() with the word by word loop used during
+// constant evaluation, and count_and/count_xor with counting
+// the result of & and ^.
+
+
+using ULLONG= unsigned long long;
+
+template<size_t N>
+using t1= Bitset2::bitset2<N,ULLONG>;
+
+template<size_t N>
+using vec_t= std::vector<t1<N> >;
+
+
+constexpr size_t n_bits_total= size_t(1) << 32;
+
+
+template<size_t N>
+vec_t<N>
+gen_bs_vec( size_t n )
+{
+  std::vector<t1<N> >           ret_val;
+  gen_random_bitset2<N,ULLONG>  gen_rand;
+  ret_val.reserve( n );
+  for( size_t c= 0; c < n; ++c ) ret_val.push_back( gen_rand() );
+
+  return ret_val;
+} // gen_bs_vec
+
+
+template<size_t N>
+size_t
+count_engine( vec_t<N> const & v )
+{
+  size_t ct= 0;
+  for( auto const & bs: v ) ct += bs.count();
+  return ct;
+}
+
+
+template<size_t N>
+size_t
+count_words( vec_t<N> const & v )
+{
+  using a_f= Bitset2::detail::array_funcs<t1<N>::n_array,ULLONG>;
+  size_t ct= 0;
+  for( auto const & bs: v ) ct += a_f().count_impl( bs.data() );
+  return ct;
+}
+
+
+template<size_t N>
+void
+bench()
+{
+  auto const   vec=     gen_bs_vec<N>( 64 );
+  size_t const n_loops= n_bits_total / ( N * vec.size() );
+
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  size_t ct1= 0;
+  for( size_t c= 0; c < n_loops; ++c ) ct1 += count_words( vec );
+
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  size_t ct2= 0;
+  for( size_t c= 0; c < n_loops; ++c ) ct2 += count_engine( vec );
+
+  auto const t3 = std::chrono::high_resolution_clock::now();
+  assert( ct1 == ct2 );
+
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  const std::chrono::duration<double> dt32 = t3 -t2;
+  std::cout << "N= " << N
+            << "\tword loop= " << dt21.count() * 1.0e3 << "ms"
+            << "\tcount()= "   << dt32.count() * 1.0e3 << "ms"
+            << "\t(" << ct1 << ")\n";
+} // bench
+
+
+template<size_t N>
+void
+bench_fused()
+{
+  auto const   vec=     gen_bs_vec<N>( 64 );
+  size_t const n_loops= n_bits_total / ( N * vec.size() * vec.size() );
+
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  size_t ct1= 0;
+  for( size_t c= 0; c < n_loops; ++c )
+    for( auto const & bs1: vec )
+      for( auto const & bs2: vec )
+        ct1 += ( bs1 & bs2 ).count() + ( bs1 ^ bs2 ).count();
+
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  size_t ct2= 0;
+  for( size_t c= 0; c < n_loops; ++c )
+    for( auto const & bs1: vec )
+      for( auto const & bs2: vec )
+        ct2 += count_and( bs1, bs2 ) + count_xor( bs1, bs2 );
+
+  auto const t3 = std::chrono::high_resolution_clock::now();
+  assert( ct1 == ct2 );
+
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  const std::chrono::duration<double> dt32 = t3 -t2;
+  std::cout << "N= " << N
+            << "\t(a&b).count()+(a^b).count()= " << dt21.count() * 1.0e3 << "ms"
+            << "\tcount_and+count_xor= "         << dt32.count() * 1.0e3 << "ms"
+            << "\t(" << ct1 << ")\n";
+} // bench_fused
+
+
+int main()
+{
+  std::cout << "Counting " << n_bits_total << " bits for each N\n";
+  bench<256>();
+  bench<1024>();
+  bench<2048>();
+  bench<4096>();
+  bench<8192>();
+  bench<16384>();
+  bench<65536>();
+
+  bench_fused<256>();
+  bench_fused<1024>();
+  bench_fused<4096>();
+  bench_fused<65536>();
+} // main
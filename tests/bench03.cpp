@@ -0,0 +1,156 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+
+
+// Compares traversal of the set bits by find_first/find_next with
+// set_bits() and decode_positions(), for dense and for sparse bitsets.
+
+
+using ULLONG= unsigned long long;
+
+template<size_t N>
+using t1= Bitset2::bitset2<N,ULLONG>;
+
+template<size_t N>
+using vec_t= std::vector<t1<N> >;
+
+
+constexpr size_t n_bits_total= size_t(1) << 28;
+
+
+/// Each bit is set with probability 2^-n_and
+template<size_t N>
+vec_t<N>
+gen_bs_vec( size_t n, size_t n_and )
+{
+  std::vector<t1<N> >           ret_val;
+  gen_random_bitset2<N,ULLONG>  gen_rand;
+  ret_val.reserve( n );
+  for( size_t c= 0; c < n; ++c )
+  {
+    auto bs= gen_rand();
+    for( size_t a= 0; a < n_and; ++a ) bs &= gen_rand();
+    ret_val.push_back( bs );
+  }
+
+  return ret_val;
+} // gen_bs_vec
+
+
+template<size_t N>
+size_t
+sum_find_next( vec_t<N> const & v )
+{
+  size_t sm= 0;
+  for( auto const & bs: v )
+  {
+    for( auto idx= bs.find_first(); idx != t1<N>::npos; idx= bs.find_next( idx ) )
+      sm += idx;
+  }
+  return sm;
+}
+
+
+template<size_t N>
+size_t
+sum_set_bits( vec_t<N> const & v )
+{
+  size_t sm= 0;
+  for( auto const & bs: v )
+  {
+    for( auto idx: bs.set_bits() ) sm += idx;
+  }
+  return sm;
+}
+
+
+template<size_t N>
+size_t
+sum_decode( vec_t<N> const & v, std::vector<uint32_t> & buf )
+{
+  size_t sm= 0;
+  for( auto const & bs: v )
+  {
+    auto const n= bs.decode_positions( buf.data() );
+    for( size_t c= 0; c < n; ++c ) sm += buf[c];
+  }
+  return sm;
+}
+
+
+template<size_t N>
+void
+bench( size_t n_and, char const * label )
+{
+  auto const   vec=     gen_bs_vec<N>( 64, n_and );
+  size_t const n_loops= n_bits_total / ( N * vec.size() );
+  // Flipping one bit per loop keeps the compiler from hoisting the sums
+  auto         vec1=    vec;
+  auto         vec2=    vec;
+  auto         vec3=    vec;
+  std::vector<uint32_t>  buf( N );
+
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  size_t sm1= 0;
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    vec1[c % vec1.size()].flip( c % N );
+    sm1 += sum_find_next( vec1 );
+  }
+
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  size_t sm2= 0;
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    vec2[c % vec2.size()].flip( c % N );
+    sm2 += sum_set_bits( vec2 );
+  }
+
+  auto const t3 = std::chrono::high_resolution_clock::now();
+  size_t sm3= 0;
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    vec3[c % vec3.size()].flip( c % N );
+    sm3 += sum_decode( vec3, buf );
+  }
+
+  auto const t4 = std::chrono::high_resolution_clock::now();
+  assert( sm1 == sm2 );
+  assert( sm1 == sm3 );
+
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  const std::chrono::duration<double> dt32 = t3 -t2;
+  const std::chrono::duration<double> dt43 = t4 -t3;
+  std::cout << "N= " << N << " " << label
+            << "\tfind_next= "  << dt21.count() * 1.0e3 << "ms"
+            << "\tset_bits()= " << dt32.count() * 1.0e3 << "ms"
+            << "\tdecode_positions()= " << dt43.count() * 1.0e3 << "ms"
+            << "\t(" << sm1 << ")\n";
+} // bench
+
+
+int main()
+{
+  bench<256>(   0, "dense " );
+  bench<256>(   5, "sparse" );
+  bench<4096>(  0, "dense " );
+  bench<4096>(  5, "sparse" );
+  bench<65536>( 0, "dense " );
+  bench<65536>( 5, "sparse" );
+} // main
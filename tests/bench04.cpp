@@ -0,0 +1,81 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../hamming_topk.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+
+
+// Searches the 10 nearest neighbours in 1M bitset2<256> by a loop over
+// (q ^ x).count(), hamming_topk, and hamming_topk_mt.
+
+
+using ULLONG= unsigned long long;
+using t1=     Bitset2::bitset2<256,ULLONG>;
+
+constexpr size_t n_db=      size_t(1) << 20;
+constexpr size_t n_queries= 20;
+constexpr size_t k=         10;
+
+
+std::vector<Bitset2::hamming_hit>
+manual_topk( t1 const & query, std::vector<t1> const & db )
+{
+  std::vector<Bitset2::hamming_hit>  all;
+  all.reserve( db.size() );
+  for( size_t c= 0; c < db.size(); ++c )
+                             all.push_back( { c, ( query ^ db[c] ).count() } );
+  std::partial_sort( all.begin(), all.begin() + k, all.end() );
+  all.resize( k );
+  return all;
+} // manual_topk
+
+
+int main()
+{
+  gen_random_bitset2<256,ULLONG>  gen_rand;
+  std::vector<t1>                 db;
+  std::vector<t1>                 queries;
+  db.reserve( n_db );
+  for( size_t c= 0; c < n_db; ++c )      db.push_back( gen_rand() );
+  for( size_t c= 0; c < n_queries; ++c ) queries.push_back( gen_rand() );
+
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  size_t sm1= 0;
+  for( auto const & q: queries ) sm1 += manual_topk( q, db ).back().distance;
+
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  size_t sm2= 0;
+  for( auto const & q: queries )
+          sm2 += Bitset2::hamming_topk( q, db.data(), n_db, k ).back().distance;
+
+  auto const t3 = std::chrono::high_resolution_clock::now();
+  size_t sm3= 0;
+  for( auto const & q: queries )
+       sm3 += Bitset2::hamming_topk_mt( q, db.data(), n_db, k ).back().distance;
+
+  auto const t4 = std::chrono::high_resolution_clock::now();
+  assert( sm1 == sm2 && sm1 == sm3 );
+
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  const std::chrono::duration<double> dt32 = t3 -t2;
+  const std::chrono::duration<double> dt43 = t4 -t3;
+  std::cout << n_queries << " queries, top " << k << " of " << n_db
+            << " x bitset2<256>"
+            << "\n(q^x).count() loop=  " << dt21.count() * 1.0e3 << "ms"
+            << "\nhamming_topk=        " << dt32.count() * 1.0e3 << "ms"
+            << "\nhamming_topk_mt=     " << dt43.count() * 1.0e3 << "ms"
+            << " (" << std::thread::hardware_concurrency() << " threads)\n";
+} // main
@@ -0,0 +1,143 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <unordered_set>
+#include <algorithm>
+
+
+// Compares std::hash<bitset2> with the former XOR-rotate combiner
+// (copied below as legacy_hash): number of colliding
+// hash values and longest bucket in an unordered_set for low entropy
+// keys, and throughput.
+
+
+using ULLONG= unsigned long long;
+
+template<size_t N>
+using t1= Bitset2::bitset2<N,ULLONG>;
+
+
+/// Former hash_impl for T=ULLONG with 64 bit size_t
+template<size_t N>
+struct legacy_hash
+{
+  size_t
+  operator()( t1<N> const & bs ) const noexcept
+  {
+    auto const & arr= bs.data();
+    if( arr.size() == 1 ) return size_t( arr[0] );
+    size_t ret_val= 0;
+    for( size_t c= 0; c < arr.size(); ++c )
+    {
+      auto crrnt= size_t( arr[c] ) + c;
+      auto const n_rot= c % 64;
+      if( n_rot > 0 ) crrnt= ( crrnt << n_rot ) | ( crrnt >> ( 64 - n_rot ) );
+      ret_val ^= crrnt;
+    }
+    return ret_val;
+  }
+}; // struct legacy_hash
+
+
+/// All bitsets with up to three bits set among the lowest bits of each
+/// word, 64 candidate positions altogether
+template<size_t N>
+std::vector<t1<N> >
+gen_low_entropy()
+{
+  std::vector<t1<N> > ret_val;
+  std::vector<size_t> pos;
+  constexpr size_t n_low= std::max( size_t(1), 64 / ( ( N + 63 ) / 64 ) );
+  for( size_t w= 0; w < N; w += 64 )
+    for( size_t b= 0; b < n_low && w + b < N; ++b ) pos.push_back( w + b );
+  auto const n= pos.size();
+  for( size_t i= 0; i < n; ++i )
+    for( size_t j= i; j < n; ++j )
+      for( size_t k= j; k < n; ++k )
+      {
+        t1<N> bs;
+        bs.set( pos[i] ).set( pos[j] ).set( pos[k] );
+        ret_val.push_back( bs );
+      }
+  std::sort( ret_val.begin(), ret_val.end() );
+  ret_val.erase( std::unique( ret_val.begin(), ret_val.end() ), ret_val.end() );
+  return ret_val;
+} // gen_low_entropy
+
+
+template<size_t N,class H>
+void
+collisions( std::vector<t1<N> > const & keys, char const * label )
+{
+  std::vector<size_t> hs;
+  for( auto const & k: keys ) hs.push_back( H{}( k ) );
+  std::sort( hs.begin(), hs.end() );
+  auto const n_dist= size_t( std::unique( hs.begin(), hs.end() ) - hs.begin() );
+
+  std::unordered_set<t1<N>,H>  set( keys.begin(), keys.end() );
+  size_t max_bckt= 0;
+  for( size_t b= 0; b < set.bucket_count(); ++b )
+                           max_bckt= std::max( max_bckt, set.bucket_size( b ) );
+
+  std::cout << "N= " << N << " " << label << "\t" << keys.size() << " keys\t"
+            << keys.size() - n_dist << " colliding hashes\tlongest bucket= "
+            << max_bckt << "\n";
+} // collisions
+
+
+template<size_t N,class H>
+double
+throughput( std::vector<t1<N> > const & keys, size_t & sm )
+{
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  for( size_t c= 0; c < 20; ++c )
+    for( auto const & k: keys ) sm += H{}( k );
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  return dt21.count() * 1.0e3;
+} // throughput
+
+
+template<size_t N>
+void
+bench()
+{
+  auto const keys= gen_low_entropy<N>();
+  collisions<N,legacy_hash<N> >(          keys, "legacy   " );
+  collisions<N,std::hash<t1<N> > >(      keys, "std::hash" );
+
+  gen_random_bitset2<N,ULLONG>  gen_rand;
+  std::vector<t1<N> >           rnd;
+  for( size_t c= 0; c < ( size_t(1) << 24 ) / N; ++c ) rnd.push_back( gen_rand() );
+  size_t sm= 0;
+  auto const dt1= throughput<N,legacy_hash<N> >(     rnd, sm );
+  auto const dt2= throughput<N,std::hash<t1<N> > >( rnd, sm );
+  std::cout << "N= " << N << "\thashing " << 20 * rnd.size() << " x bitset2"
+            << "\tlegacy= " << dt1 << "ms\tstd::hash= " << dt2 << "ms"
+            << "\t(" << sm % 10 << ")\n";
+} // bench
+
+
+int main()
+{
+  bench<64>();
+  bench<128>();
+  bench<256>();
+  bench<1024>();
+  bench<4096>();
+} // main
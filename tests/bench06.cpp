@@ -0,0 +1,129 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+
+// Chains expressions like a | b | c | d on large bitsets. The rvalue
+// overloads work in place on the temporaries instead of building a new
+// array for each intermediate result. Prints the time per expression
+// and, for heap_storage, the number of blocks allocated per expression,
+// i.e. the number of materialized intermediates.
+
+
+using ULLONG= unsigned long long;
+
+constexpr size_t N= 65536;
+
+
+/// Counts allocations on top of operator new
+struct counting_arena
+{
+  static size_t  n_allocs;
+
+  static
+  void *
+  allocate( size_t n_bytes, size_t alignment )
+  {
+    ++n_allocs;
+    return Bitset2::detail::new_delete_arena::allocate( n_bytes, alignment );
+  }
+
+  static
+  void
+  deallocate( void *p, size_t n_bytes, size_t alignment ) noexcept
+  { Bitset2::detail::new_delete_arena::deallocate( p, n_bytes, alignment ); }
+}; // struct counting_arena
+
+size_t counting_arena::n_allocs= 0;
+
+
+template<class BS>
+std::vector<BS>
+gen_bs_vec( size_t n )
+{
+  gen_random_bitset2<N,ULLONG>  gen_rand;
+  std::vector<BS>               ret_val;
+  for( size_t c= 0; c < n; ++c ) ret_val.emplace_back( gen_rand().data() );
+  return ret_val;
+}
+
+
+template<class BS,class F>
+void
+run( char const *storage, char const *expr, size_t n_loops, F f )
+{
+  auto const v= gen_bs_vec<BS>( 8 );
+  size_t     dummy= 0;
+
+  // Minimum of n_rep runs, the machine may be busy
+  constexpr size_t  n_rep= 5;
+  double            t_min= 0.0;
+  auto const n_allocs0= counting_arena::n_allocs;
+  for( size_t rep= 0; rep < n_rep; ++rep )
+  {
+    auto const t1= std::chrono::high_resolution_clock::now();
+    for( size_t c= 0; c < n_loops; ++c )
+    {
+      BS const r= f( v[c % 5], v[c % 5 + 1], v[c % 5 + 2], v[c % 5 + 3] );
+      dummy += r.data()[c % r.data().size()];
+    }
+    auto const t2= std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double,std::nano> const dt= t2 - t1;
+    if( rep == 0 || dt.count() < t_min ) t_min= dt.count();
+  }
+  auto const n_allocs= ( counting_arena::n_allocs - n_allocs0 ) / n_rep;
+
+  std::cout << storage << "  " << expr << ": "
+            << t_min / double( n_loops ) << " ns";
+  if( n_allocs > 0 )
+    std::cout << ", " << double( n_allocs ) / double( n_loops ) << " allocs";
+  std::cout << "  (" << dummy % 2 << ")\n";
+} // run
+
+
+template<class BS>
+void
+run_all( char const *storage, size_t n_loops )
+{
+  using bs_t= BS const &;
+  run<BS>( storage, "a | b | c | d      ", n_loops,
+           []( bs_t a, bs_t b, bs_t c, bs_t d ) { return a | b | c | d; } );
+  run<BS>( storage, "(a ^ b) & ~(c | d) ", n_loops,
+           []( bs_t a, bs_t b, bs_t c, bs_t d ) { return ( a ^ b ) & ~( c | d ); } );
+  run<BS>( storage, "difference(a|b,c^d)", n_loops,
+           []( bs_t a, bs_t b, bs_t c, bs_t d )
+           { return Bitset2::difference( a | b, c ^ d ); } );
+  run<BS>( storage, "reverse(a & b)     ", n_loops,
+           []( bs_t a, bs_t b, bs_t, bs_t )
+           { return Bitset2::reverse( a & b ); } );
+  run<BS>( storage, "rotate_left(a^b,77)", n_loops,
+           []( bs_t a, bs_t b, bs_t, bs_t )
+           { return Bitset2::rotate_left( a ^ b, 77 ); } );
+} // run_all
+
+
+int main( int argc, char *argv[] )
+{
+  size_t const n_loops= argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 50000;
+
+  std::cout << "N= " << N << ", " << n_loops << " loops\n";
+  run_all<Bitset2::bitset2<N,ULLONG> >( "inline", n_loops );
+  run_all<Bitset2::bitset2<N,ULLONG,
+                           Bitset2::arena_storage<counting_arena> > >( "heap  ", n_loops );
+} // main
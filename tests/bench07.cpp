@@ -0,0 +1,89 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../lazy_bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+
+// Evaluates a predicate on eight columns of a bitmap index, like
+//   ( ( c0 & c1 ) | ( c2 & ~c3 ) ) & ( c4 | c5 ) & ~( c6 ^ c7 )
+// with the eager operators, which materialize each intermediate result,
+// and as a lazy expression, which is evaluated in one pass. Prints the
+// time per evaluation for materializing the result, count() and any().
+
+
+using ULLONG= unsigned long long;
+
+constexpr size_t N= 65536;
+using bs_t= Bitset2::bitset2<N,ULLONG>;
+
+
+template<class F>
+void
+run( char const *what, std::vector<bs_t> const &v, size_t n_loops, F f )
+{
+  size_t dummy= 0;
+
+  // Minimum of n_rep runs, the machine may be busy
+  constexpr size_t  n_rep= 5;
+  double            t_min= 0.0;
+  for( size_t rep= 0; rep < n_rep; ++rep )
+  {
+    auto const t1= std::chrono::high_resolution_clock::now();
+    for( size_t c= 0; c < n_loops; ++c ) dummy += f( v.data() + c % 8 );
+    auto const t2= std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double,std::nano> const dt= t2 - t1;
+    if( rep == 0 || dt.count() < t_min ) t_min= dt.count();
+  }
+
+  std::cout << what << ": " << t_min / double( n_loops ) << " ns"
+            << "  (" << dummy % 2 << ")\n";
+} // run
+
+
+int main( int argc, char *argv[] )
+{
+  size_t const n_loops= argc > 1 ? std::strtoul( argv[1], nullptr, 10 ) : 20000;
+
+  gen_random_bitset2<N,ULLONG>  gen_rand;
+  std::vector<bs_t>             v;
+  for( size_t c= 0; c < 16; ++c ) v.push_back( gen_rand() );
+
+  std::cout << "N= " << N << ", " << n_loops << " loops\n";
+
+  auto const eager= []( bs_t const *c )
+  { return ( ( c[0] & c[1] ) | ( c[2] & ~c[3] ) ) & ( c[4] | c[5] ) & ~( c[6] ^ c[7] ); };
+  auto const lazy= []( bs_t const *c )
+  {
+    using Bitset2::lazy;
+    return ( ( lazy( c[0] ) & c[1] ) | ( lazy( c[2] ) & ~lazy( c[3] ) ) )
+           & ( lazy( c[4] ) | c[5] ) & ~( lazy( c[6] ) ^ c[7] );
+  };
+
+  run( "eager materialize", v, n_loops,
+       [&]( bs_t const *c ) { return eager( c ).data()[c - v.data()]; } );
+  run( "lazy  materialize", v, n_loops,
+       [&]( bs_t const *c ) { return bs_t( lazy( c ) ).data()[c - v.data()]; } );
+  run( "eager count      ", v, n_loops,
+       [&]( bs_t const *c ) { return eager( c ).count(); } );
+  run( "lazy  count      ", v, n_loops,
+       [&]( bs_t const *c ) { return lazy( c ).count(); } );
+  run( "eager any        ", v, n_loops,
+       [&]( bs_t const *c ) { return size_t( eager( c ).any() ); } );
+  run( "lazy  any        ", v, n_loops,
+       [&]( bs_t const *c ) { return size_t( lazy( c ).any() ); } );
+} // main
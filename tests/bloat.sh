@@ -0,0 +1,32 @@
+# Compares the text section size and the instruction cache misses of
+# bloat01.cpp, which uses bitset2<N> for 200 different N, with and
+# without the shared (out-of-line) runtime kernels. Uses perf for the
+# cache misses if available.
+
+cc=g++-12
+#cc=clang++
+
+std=c++20
+
+p=bloat01
+flags="-O2 -Wall -Wextra -std=$std -I.. $*"
+
+for variant in shared inline
+do
+  if [ $variant = inline ]
+  then
+    vflags="-DBITSET2_NO_SHARED_KERNELS"
+  else
+    vflags=""
+  fi
+  echo "== $variant"
+  $cc $flags $vflags $p.cpp -o ${p}_$variant || exit 1
+  size -A ${p}_$variant | grep -E '^\.text'
+  if command -v perf > /dev/null
+  then
+    perf stat -e instructions,L1-icache-load-misses,iTLB-load-misses \
+      ./${p}_$variant
+  else
+    ./${p}_$variant
+  fi
+done
@@ -0,0 +1,78 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+#include "../bitset2.hpp"
+#include <iostream>
+#include <chrono>
+#include <utility>
+#include <functional>
+#include <cstdlib>
+#include <cstdint>
+
+
+// Uses bitset2<N> for 200 different N (100, 113, ..., 2687), each with
+// the same mix of operations, and calls all of them in turn. Compile
+// with and without -DBITSET2_NO_SHARED_KERNELS for comparing the size
+// of the text section and instruction cache misses (see bloat.sh).
+
+
+using ULLONG= unsigned long long;
+
+constexpr size_t n_sizes=  200;
+constexpr size_t n_first=  100;
+constexpr size_t n_step=   13;
+
+
+template<size_t N>
+uint64_t
+work( uint64_t seed )
+{
+  using bs_t= Bitset2::bitset2<N,ULLONG>;
+
+  bs_t b1( seed | 1 );
+  b1 |= Bitset2::rotate_left( b1, size_t( seed % N ) );
+  bs_t b2= ~( b1 << size_t( seed % 61 ) );
+  b2 ^= Bitset2::reverse( b1 );
+  auto const b3= b1 + b2;
+  uint64_t ret_val= b3.count() + count_xor( b1, b2 );
+  ret_val += b2.find_first() + b2.find_next( N / 2 ) + b3.find_last();
+  ret_val += b1.rank( N / 3 ) + ( b1 < b2 ) + ( b1 == b3 );
+  ret_val += std::hash<bs_t>()( b3 );
+  return ret_val;
+} // work
+
+
+template<size_t ... I>
+uint64_t
+work_all( uint64_t seed, std::index_sequence<I...> )
+{
+  uint64_t ret_val= 0;
+  ( ( ret_val += work<n_first + I * n_step>( seed + ret_val ) ), ... );
+  return ret_val;
+}
+
+
+int main( int argc, char *argv[] )
+{
+  size_t const n_rounds= argc > 1 ? size_t( std::atol( argv[1] ) ) : 20000;
+
+  auto const t1= std::chrono::high_resolution_clock::now();
+  uint64_t   sum= 0;
+  for( size_t c= 0; c < n_rounds; ++c )
+    sum += work_all( c + sum, std::make_index_sequence<n_sizes>() );
+  auto const t2= std::chrono::high_resolution_clock::now();
+
+  std::cout << n_sizes << " sizes, " << n_rounds << " rounds: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(t2-t1).count()
+            << " ms (checksum " << sum << ")\n";
+} // main
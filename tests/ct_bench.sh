@@ -0,0 +1,25 @@
+# Records compile time and peak compiler memory of ct_bench01.cpp
+# for growing N (64 ... 2^22). Uses GNU time (/usr/bin/time) for the
+# peak memory if available, otherwise the shell's time.
+
+cc=g++-12
+#cc=clang++
+
+std=c++20
+
+p=ct_bench01
+flags="-O2 -Wall -Wextra -std=$std -I..
+       -fconstexpr-ops-limit=4294967296 -fconstexpr-loop-limit=16777216"
+
+for e in 6 8 10 12 14 16 18 20 22
+do
+  n=$(( 1 << e ))
+  if [ -x /usr/bin/time ]
+  then
+    /usr/bin/time -f "N= $n	%e s	%M kB" \
+      $cc $flags -DBS2_N=$n $p.cpp -o $p || echo "N= $n failed"
+  else
+    echo "N= $n"
+    time $cc $flags -DBS2_N=$n $p.cpp -o $p || echo "N= $n failed"
+  fi
+done
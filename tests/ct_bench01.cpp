@@ -0,0 +1,61 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Constant-evaluates the main operations for bitset2<BS2_N>.
+// Used by ct_bench.sh to record compile time and compiler memory.
+
+
+#include "../bitset2.hpp"
+#include <iostream>
+
+
+#ifndef BS2_N
+#define BS2_N 1024
+#endif
+
+
+using ULLONG= unsigned long long;
+using t1=     Bitset2::bitset2<BS2_N,ULLONG>;
+
+
+constexpr
+bool
+ce_ops()
+{
+  t1 const  b1= t1(0xF0F0ull) << ( BS2_N / 2 );
+  t1 const  b2= ~b1;
+  t1 const  b3= b1 | b2;
+  t1        b4= b1;
+  b4 ^= b2;
+  b4.difference( b1 );
+
+  return    b3.all()
+         && ( b1 & b2 ).none()
+         && b4 == b2
+         && b1 < b2
+         && !( b2 < b1 )
+         && b1.count() == 8
+         && b2.count() == BS2_N - 8
+         && t1( b1 ).reverse().count() == 8
+         && ( b1 >> ( BS2_N / 2 ) ) == t1(0xF0F0ull)
+         && t1( b1 ).flip().flip() == b1;
+} // ce_ops
+
+
+static_assert( ce_ops(), "ce_ops failed" );
+
+
+int main()
+{
+  std::cout << "N= " << BS2_N << " ok\n";
+} // main
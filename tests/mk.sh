@@ -31,6 +31,15 @@ p=test_bitset2_02
 echo "Compiling $p"
 $cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
 
+p=test_rank_select
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_count_index
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=c++17 -I.. -fdiagnostics-color=auto $p.cpp -o ${p}_17
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
 p=counter128
 echo "Compiling $p"
 $cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
@@ -39,6 +48,62 @@ p=bench01
 echo "Compiling $p"
 $cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto -D_GLIBCXX_USE_NANOSLEEP $p.cpp -o $p
 
+p=bench02
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
 p=example01
 echo "Compiling $p"
 $cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=ct_bench01
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=bench03
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_hamming
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -pthread -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_hamming_index
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=bench04
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -pthread -fdiagnostics-color=auto $p.cpp -o $p
+
+p=bench05
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_dynamic_bitset2
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_bounded_bitset2
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=bloat01
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_storage_policy
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=bench06
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=test_lazy_bitset2
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
+
+p=bench07
+echo "Compiling $p"
+$cc -O2 -Wall -Wextra -std=$std -I.. -fdiagnostics-color=auto $p.cpp -o $p
@@ -0,0 +1,221 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks bounded_bitset2 against bitset2 of the same size.
+
+
+#include "../bounded_bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+
+constexpr size_t n_loops= 50;
+
+
+template<size_t MaxN,size_t N,class T>
+void
+test_bounded_bitset2( char const * type_str )
+{
+  std::cout << "Entering test_bounded_bitset2 MaxN= " << MaxN << " N= " << N
+            << " type= " << type_str << "\n";
+
+  using bs_t=  Bitset2::bitset2<N,T>;
+  using bbs_t= Bitset2::bounded_bitset2<MaxN,T>;
+
+  auto const is_eq= []( bbs_t const &d, bs_t const &b )
+  { return d.size() == N && d.template to_bitset2<N>() == b; };
+
+  gen_random_bitset2<N,T>  gen_rand;
+  gen_randoms<size_t>      gen_idx( 2 * N + 2 );
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    bs_t b1= gen_rand();
+    bs_t b2= gen_rand();
+    if( c == 0 ) b1.reset();
+    if( c == 1 ) b1.set();
+    if( c == 2 ) b2= b1;
+    bbs_t const d1( b1 );
+    bbs_t const d2( b2 );
+    auto const sh= gen_idx();
+
+    assert( is_eq( d1, b1 ) );
+    assert( bbs_t( b1.to_string() ) == d1 );
+    assert( d1.to_string() == b1.to_string() );
+    assert( d1.to_hex_string() == b1.to_hex_string() );
+
+    assert( d1.none()           == b1.none() );
+    assert( d1.all()            == b1.all() );
+    assert( d1.count()          == b1.count() );
+    assert( d1.has_single_bit() == b1.has_single_bit() );
+    assert( d1.find_first()      == b1.find_first() );
+    assert( d1.find_first_zero() == b1.find_first_zero() );
+    assert( d1.find_last()       == b1.find_last() );
+    assert( d1.find_last_zero()  == b1.find_last_zero() );
+    for( size_t i= 0; i < N; i += N / 16 + 1 )
+    {
+      assert( d1.find_next( i )      == b1.find_next( i ) );
+      assert( d1.find_next_zero( i ) == b1.find_next_zero( i ) );
+      assert( d1.rank( i )           == b1.rank( i ) );
+      assert( d1.select( i )         == b1.select( i ) );
+    }
+
+    assert( is_eq( ~d1, ~b1 ) );
+    assert( is_eq( d1 & d2, b1 & b2 ) );
+    assert( is_eq( d1 | d2, b1 | b2 ) );
+    assert( is_eq( d1 ^ d2, b1 ^ b2 ) );
+    assert( is_eq( Bitset2::difference( d1, d2 ), Bitset2::difference( b1, b2 ) ) );
+    assert( count_and( d1, d2 ) == count_and( b1, b2 ) );
+    assert( count_xor( d1, d2 ) == count_xor( b1, b2 ) );
+
+    assert( is_eq( d1 << sh, b1 << sh ) );
+    assert( is_eq( d1 >> sh, b1 >> sh ) );
+    assert( is_eq( Bitset2::rotate_left( d1, sh ),  Bitset2::rotate_left( b1, sh ) ) );
+    assert( is_eq( Bitset2::rotate_right( d1, sh ), Bitset2::rotate_right( b1, sh ) ) );
+    assert( is_eq( Bitset2::reverse( d1 ),     Bitset2::reverse( b1 ) ) );
+    assert( is_eq( Bitset2::complement2( d1 ), Bitset2::complement2( b1 ) ) );
+    assert( is_eq( d1 + d2, b1 + b2 ) );
+    auto d3= d1;
+    auto b3= b1;
+    assert( is_eq( ++d3, ++b3 ) );
+    assert( is_eq( --d3, --b3 ) );
+    assert( is_eq( --d3, --b3 ) );
+
+    assert( ( d1 == d2 ) == ( b1 == b2 ) );
+    assert( ( d1 <  d2 ) == ( b1 <  b2 ) );
+    assert( ( d1 >= d2 ) == ( b1 >= b2 ) );
+
+    // Growing and shrinking keeps the bits below the new size
+    auto d4= d1;
+    auto const n_grow= std::min( sh, MaxN - N );
+    d4.resize( N + n_grow, true );
+    assert( d4.count() == d1.count() + n_grow );
+    d4.resize( N );
+    assert( d4 == d1 );
+  } // for c
+} // test_bounded_bitset2
+
+
+/// Bits a b c in a bounded_bitset2<MaxN> of n bits
+template<size_t MaxN>
+constexpr
+Bitset2::bounded_bitset2<MaxN>
+ce_bits( size_t n, size_t a, size_t b, size_t c )
+{
+  Bitset2::bounded_bitset2<MaxN> ret_val( n );
+  ret_val.set( a ).set( b ).set( c );
+  return ret_val;
+}
+
+
+void
+test_constexpr()
+{
+  std::cout << "Entering test_constexpr\n";
+
+  using namespace Bitset2;
+  constexpr auto b1= ce_bits<200>( 150, 3, 70, 149 );
+  constexpr auto b2= ce_bits<200>( 150, 4, 70, 100 );
+  static_assert( b1.size() == 150 && b1.count() == 3 );
+  static_assert( b1.find_last() == 149 && b1.find_next( 3 ) == 70 );
+  static_assert( b1.rank( 100 ) == 2 && b1.select( 2 ) == 149 );
+  static_assert( ( b1 & b2 ).count() == 1 && ( b1 | b2 ).count() == 5 );
+  static_assert( count_xor( b1, b2 ) == 4 );
+  static_assert( ( b1 << 1 ).find_last() == 70 + 1 );
+  static_assert( rotate_left( b1, 1 ).find_first() == 0 );
+  static_assert( reverse( b1 ).find_first() == 0 );
+  static_assert( ( b1 + b2 ).count() == 5 );
+  static_assert( ( ~b1 ).count() == 147 && ( ~b1 ).find_last() == 148 );
+  static_assert( b1 != b2 && b1 < ce_bits<200>( 151, 0, 1, 2 ) );
+  static_assert( bounded_bitset2<200>( 150, 0xF0ull ).to_ullong() == 0xF0 );
+  static_assert( bounded_bitset2<200>( bitset2<70>( 5ull ) ).count() == 2 );
+  static_assert( b1.to_bitset2<150>() == ( bitset2<150>( 1ull ) << 149 )
+                                        + ( bitset2<150>( 1ull ) << 70 ) + bitset2<150>( 8ull ) );
+
+  constexpr auto b3= []()
+  {
+    bounded_bitset2<100,uint8_t> b( 5, 0x1Full );
+    b.resize( 20, true );
+    b.resize( 10 );
+    b.push_back( false );
+    b.resize( 100 );
+    return b;
+  }();
+  static_assert( b3.size() == 100 && b3.count() == 10 && b3.find_last() == 9 );
+  static_assert( sizeof( bounded_bitset2<200,uint64_t> ) == 4 * 8 + sizeof( size_t ) );
+} // test_constexpr
+
+
+void
+test_resize()
+{
+  std::cout << "Entering test_resize\n";
+
+  using bbs_t= Bitset2::bounded_bitset2<1000,uint32_t>;
+
+  bbs_t d;
+  std::vector<bool> model;
+  for( size_t n= 0; n <= 1000; n += 37 )
+  {
+    d.resize( n, n % 2 == 0 );
+    model.resize( n, n % 2 == 0 );
+    assert( d.size() == n );
+    d.resize( n / 3 );
+    model.resize( n / 3 );
+    assert( d.size() == n / 3 );
+    for( size_t i= 0; i < model.size(); ++i ) assert( d[i] == model[i] );
+    assert( d.count() == size_t( std::count( model.begin(), model.end(), true ) ) );
+  }
+  while( d.size() < bbs_t::max_size() )
+  {
+    d.push_back( d.size() % 3 == 0 );
+    model.push_back( d.size() % 3 == 1 );
+  }
+  assert( d.count() == size_t( std::count( model.begin(), model.end(), true ) ) );
+
+  bool thrown= false;
+  try { d.push_back( true ); }
+  catch( std::length_error const & ) { thrown= true; }
+  assert( thrown );
+  thrown= false;
+  try { bbs_t( 1001 ); }
+  catch( std::length_error const & ) { thrown= true; }
+  assert( thrown );
+  thrown= false;
+  try { bbs_t( 10 ) & bbs_t( 11 ); }
+  catch( std::invalid_argument const & ) { thrown= true; }
+  assert( thrown );
+  d.clear();
+  assert( d.empty() && d.none() && d.find_first() == bbs_t::npos );
+} // test_resize
+
+
+int main()
+{
+  test_bounded_bitset2<8,1,uint8_t>(                   "uint8_t" );
+  test_bounded_bitset2<100,8,uint8_t>(                 "uint8_t" );
+  test_bounded_bitset2<100,65,uint8_t>(                "uint8_t" );
+  test_bounded_bitset2<100,100,uint16_t>(              "uint16_t" );
+  test_bounded_bitset2<1000,64,unsigned long long>(    "U_L_LONG" );
+  test_bounded_bitset2<1000,130,unsigned long long>(   "U_L_LONG" );
+  test_bounded_bitset2<1000,1000,unsigned long long>(  "U_L_LONG" );
+  test_bounded_bitset2<300,130,uint32_t>(              "uint32_t" );
+#ifdef __SIZEOF_INT128__
+  test_bounded_bitset2<512,300,unsigned __int128>(     "uint128" );
+#endif
+  test_constexpr();
+  test_resize();
+} // main
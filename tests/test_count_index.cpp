@@ -0,0 +1,118 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks that count_bits, index_lsb_set, index_msb_set, and
+// select_bit_set give the same results as their portable implementations. Compile with
+// -std=c++17 and -std=c++20 to cover the builtin and the <bit> versions.
+
+
+#include "../bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <climits>
+
+
+constexpr size_t n_loops= 100000;
+
+
+template<class T>
+constexpr
+bool
+ce_check( T val )
+{
+  using namespace Bitset2::detail;
+  return  count_bits( val ) == count_bits_generic( val )
+       && ( val == T(0) || index_lsb_set<T>()( val ) == index_lsb_set<T>().impl( val ) )
+       && ( val == T(0) || index_msb_set<T>()( val ) == index_msb_set<T>().impl( val ) );
+}
+
+
+template<class T>
+void
+check( T val )
+{
+  using namespace Bitset2::detail;
+  constexpr auto npos= index_lsb_set<T>::npos;
+
+  assert( count_bits( val ) == count_bits_generic( val ) );
+  if( val == T(0) )
+  {
+    assert( index_lsb_set<T>()( val ) == npos );
+    assert( index_msb_set<T>()( val ) == npos );
+    return;
+  }
+  assert( index_lsb_set<T>()( val ) == index_lsb_set<T>().impl( val ) );
+  assert( index_msb_set<T>()( val ) == index_msb_set<T>().impl( val ) );
+  for( size_t k= 0; k <= count_bits( val ); ++k )
+    assert( select_bit_set<T>()( val, k ) == select_bit_set<T>().impl( val, k ) );
+} // check
+
+
+template<class T>
+void
+test_count_index( char const * type_str )
+{
+  std::cout << "Entering test_count_index type= " << type_str << "\n";
+
+  constexpr size_t  n_bits= sizeof(T) * CHAR_BIT;
+  constexpr T       all_one= T(~T(0));
+
+  static_assert( ce_check( T(0) ) );
+  static_assert( ce_check( T(1) ) );
+  static_assert( ce_check( all_one ) );
+  static_assert( ce_check( T( all_one >> 1 ) ) );
+  static_assert( ce_check( T( T(1) << ( n_bits - 1 ) ) ) );
+  static_assert( Bitset2::detail::count_bits( all_one ) == n_bits );
+  static_assert( Bitset2::detail::index_msb_set<T>()( all_one ) == n_bits - 1 );
+  static_assert( Bitset2::detail::select_bit_set<T>()( all_one, n_bits - 1 )
+                 == n_bits - 1 );
+  static_assert( Bitset2::detail::select_bit_set<T>()( T(6), 1 ) == 2 );
+  static_assert( Bitset2::detail::select_bit_set<T>()( T(6), 2 )
+                 == Bitset2::detail::select_bit_set<T>::npos );
+
+  check( T(0) );
+  check( all_one );
+  for( size_t b= 0; b < n_bits; ++b )
+  {
+    check( T( T(1) << b ) );
+    check( T( all_one << b ) );
+    check( T( all_one >> b ) );
+  }
+
+  gen_randoms<T>  gen_rand( all_one );
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    auto const val= gen_rand();
+    check( val );
+    check( T( val >> ( c % n_bits ) ) );
+  }
+} // test_count_index
+
+
+int main()
+{
+  std::cout << "__cplusplus= " << __cplusplus << "\n";
+
+  test_count_index<uint8_t>(            "uint8_t" );
+  test_count_index<unsigned short>(     "u_short" );
+  test_count_index<unsigned int>(       "u_int" );
+  test_count_index<unsigned long>(      "u_long" );
+  test_count_index<unsigned long long>( "U_L_LONG" );
+  test_count_index<uint16_t>(           "uint16_t" );
+  test_count_index<uint32_t>(           "uint32_t" );
+  test_count_index<uint64_t>(           "uint64_t" );
+#ifdef __SIZEOF_INT128__
+  test_count_index<unsigned __int128>(  "uint128" );
+#endif
+} // main
@@ -0,0 +1,224 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks dynamic_bitset2 against bitset2 of the same size.
+
+
+#include "../dynamic_bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+
+constexpr size_t n_loops= 50;
+
+
+/// Counts allocations, for checking that resize does not reallocate
+template<class T>
+struct counting_alloc
+{
+  using value_type= T;
+
+  static size_t n_allocs;
+
+  counting_alloc()= default;
+  template<class U>
+  counting_alloc( counting_alloc<U> const & ) noexcept {}
+
+  T *
+  allocate( size_t n )
+  {
+    ++n_allocs;
+    return std::allocator<T>().allocate( n );
+  }
+
+  void
+  deallocate( T *p, size_t n ) noexcept
+  { std::allocator<T>().deallocate( p, n ); }
+
+  friend bool operator==( counting_alloc, counting_alloc ) { return true; }
+  friend bool operator!=( counting_alloc, counting_alloc ) { return false; }
+}; // struct counting_alloc
+
+template<class T>
+size_t counting_alloc<T>::n_allocs= 0;
+
+
+template<size_t N,class T>
+void
+test_dynamic_bitset2( char const * type_str )
+{
+  std::cout << "Entering test_dynamic_bitset2 N= " << N << " type= "
+            << type_str << "\n";
+
+  using bs_t=  Bitset2::bitset2<N,T>;
+  using dbs_t= Bitset2::dynamic_bitset2<T>;
+
+  auto const is_eq= []( dbs_t const &d, bs_t const &b )
+  { return d.size() == N && d.template to_bitset2<N>() == b; };
+
+  gen_random_bitset2<N,T>  gen_rand;
+  gen_randoms<size_t>      gen_idx( 2 * N + 2 );
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    bs_t b1= gen_rand();
+    bs_t b2= gen_rand();
+    if( c == 0 ) b1.reset();
+    if( c == 1 ) b1.set();
+    if( c == 2 ) b2= b1;
+    dbs_t const d1( b1 );
+    dbs_t const d2( b2 );
+    auto const sh= gen_idx();
+
+    assert( is_eq( d1, b1 ) );
+    assert( dbs_t( b1.to_string() ) == d1 );
+    assert( d1.to_string() == b1.to_string() );
+    assert( d1.to_hex_string() == b1.to_hex_string() );
+    assert( d1.to_hex_string( Bitset2::hex_params<>{'0','A',false,true,"0x"} )
+            == b1.to_hex_string( Bitset2::hex_params<>{'0','A',false,true,"0x"} ) );
+
+    assert( d1.none()           == b1.none() );
+    assert( d1.any()            == b1.any() );
+    assert( d1.all()            == b1.all() );
+    assert( d1.count()          == b1.count() );
+    assert( d1.has_single_bit() == b1.has_single_bit() );
+    assert( d1.find_first()      == b1.find_first() );
+    assert( d1.find_first_zero() == b1.find_first_zero() );
+    assert( d1.find_last()       == b1.find_last() );
+    assert( d1.find_last_zero()  == b1.find_last_zero() );
+    for( size_t i= 0; i < N; i += N / 16 + 1 )
+    {
+      assert( d1.find_next( i )      == b1.find_next( i ) );
+      assert( d1.find_next_zero( i ) == b1.find_next_zero( i ) );
+      assert( d1.rank( i )           == b1.rank( i ) );
+      assert( d1.select( i )         == b1.select( i ) );
+    }
+
+    assert( is_eq( ~d1, ~b1 ) );
+    assert( is_eq( d1 & d2, b1 & b2 ) );
+    assert( is_eq( d1 | d2, b1 | b2 ) );
+    assert( is_eq( d1 ^ d2, b1 ^ b2 ) );
+    assert( is_eq( Bitset2::difference( d1, d2 ), Bitset2::difference( b1, b2 ) ) );
+    assert( count_and( d1, d2 )        == count_and( b1, b2 ) );
+    assert( count_or( d1, d2 )         == count_or( b1, b2 ) );
+    assert( count_xor( d1, d2 )        == count_xor( b1, b2 ) );
+    assert( count_difference( d1, d2 ) == count_difference( b1, b2 ) );
+
+    assert( is_eq( d1 << sh, b1 << sh ) );
+    assert( is_eq( d1 >> sh, b1 >> sh ) );
+    assert( is_eq( Bitset2::rotate_left( d1, sh ),  Bitset2::rotate_left( b1, sh ) ) );
+    assert( is_eq( Bitset2::rotate_right( d1, sh ), Bitset2::rotate_right( b1, sh ) ) );
+    assert( is_eq( Bitset2::reverse( d1 ),     Bitset2::reverse( b1 ) ) );
+    assert( is_eq( Bitset2::complement2( d1 ), Bitset2::complement2( b1 ) ) );
+    assert( is_eq( d1 + d2, b1 + b2 ) );
+    auto d3= d1;
+    auto b3= b1;
+    assert( is_eq( ++d3, ++b3 ) );
+    assert( is_eq( --d3, --b3 ) );
+    assert( is_eq( --d3, --b3 ) );
+
+    auto const lo= sh % ( N + 1 );
+    auto const hi= lo + ( N - lo ) / 2;
+    assert( d1.count_range( lo, hi )  == b1.count_range( lo, hi ) );
+    assert( d1.any_in_range( lo, hi ) == b1.any_in_range( lo, hi ) );
+    assert( is_eq( d3.set_range( lo, hi ),   b3.set_range( lo, hi ) ) );
+    assert( is_eq( d3.flip_range( 0, hi ),   b3.flip_range( 0, hi ) ) );
+    assert( is_eq( d3.reset_range( lo, N ),  b3.reset_range( lo, N ) ) );
+
+    assert( ( d1 == d2 ) == ( b1 == b2 ) );
+    assert( ( d1 <  d2 ) == ( b1 <  b2 ) );
+    assert( ( d1 >  d2 ) == ( b1 >  b2 ) );
+    assert( ( d1 <= d2 ) == ( b1 <= b2 ) );
+
+    // Growing and shrinking keeps the bits below the new size
+    auto d4= d1;
+    d4.resize( N + sh, true );
+    assert( d4.count() == d1.count() + sh );
+    d4.resize( N );
+    assert( d4 == d1 );
+    d4.push_back( true );
+    assert( d4.size() == N + 1 && d4.find_last() == N );
+  } // for c
+} // test_dynamic_bitset2
+
+
+void
+test_resize()
+{
+  std::cout << "Entering test_resize\n";
+
+  using dbs_t= Bitset2::dynamic_bitset2<uint32_t,counting_alloc<uint32_t> >;
+
+  dbs_t d;
+  d.reserve( 10000 );
+  assert( d.capacity() >= 10000 );
+  auto const n_allocs= counting_alloc<uint32_t>::n_allocs;
+  auto const ptr= d.data();
+  std::vector<bool> model;
+  for( size_t n= 0; n <= 10000; n += 77 )
+  {
+    d.resize( n, n % 2 == 0 );
+    model.resize( n, n % 2 == 0 );
+    assert( d.size() == n );
+    d.resize( n / 3 );
+    model.resize( n / 3 );
+    assert( d.size() == n / 3 );
+    for( size_t i= 0; i < model.size(); ++i ) assert( d[i] == model[i] );
+    assert( d.count() == size_t( std::count( model.begin(), model.end(), true ) ) );
+  }
+  for( size_t c= 0; c < 10000 - d.size(); ++c ) d.push_back( c % 3 == 0 );
+  assert( counting_alloc<uint32_t>::n_allocs == n_allocs );
+  assert( d.data() == ptr );
+
+  dbs_t d2( 100, 0xF0ull );
+  assert( d2.to_ullong() == 0xF0 && d2.count() == 4 );
+  d2.resize( 3 );
+  assert( d2.none() );
+  d2.resize( 35, true );
+  assert( d2.count() == 32 && d2.find_first() == 3 );
+  d2.resize( 100 );
+  assert( d2.count() == 32 && d2.find_last() == 34 );
+  d2.clear();
+  assert( d2.empty() && d2.none() && !d2.all() );
+  assert( d2.find_first() == dbs_t::npos && d2.find_first_zero() == dbs_t::npos );
+
+  bool thrown= false;
+  try { dbs_t( 10 ) & dbs_t( 11 ); }
+  catch( std::invalid_argument const & ) { thrown= true; }
+  assert( thrown );
+  thrown= false;
+  try { dbs_t( 10 ).set( 10 ); }
+  catch( std::out_of_range const & ) { thrown= true; }
+  assert( thrown );
+  assert( dbs_t( 10 ) < dbs_t( 11 ) && dbs_t( 10 ) != dbs_t( 11 ) );
+} // test_resize
+
+
+int main()
+{
+  test_dynamic_bitset2<1,uint8_t>(                  "uint8_t" );
+  test_dynamic_bitset2<8,uint8_t>(                  "uint8_t" );
+  test_dynamic_bitset2<65,uint8_t>(                 "uint8_t" );
+  test_dynamic_bitset2<100,uint16_t>(               "uint16_t" );
+  test_dynamic_bitset2<64,unsigned long long>(      "U_L_LONG" );
+  test_dynamic_bitset2<130,uint32_t>(               "uint32_t" );
+  test_dynamic_bitset2<1000,unsigned long long>(    "U_L_LONG" );
+  test_dynamic_bitset2<4096,unsigned long long>(    "U_L_LONG" );
+#ifdef __SIZEOF_INT128__
+  test_dynamic_bitset2<300,unsigned __int128>(      "uint128" );
+#endif
+  test_resize();
+} // main
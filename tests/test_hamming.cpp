@@ -0,0 +1,85 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks hamming_topk and hamming_topk_mt against sorting all distances.
+
+
+#include "../hamming_topk.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+
+
+constexpr size_t n_loops= 10;
+
+
+template<size_t N,class T>
+void
+test_topk( char const * type_str, size_t n_db, size_t n_and )
+{
+  std::cout << "Entering test_topk N= " << N << " type= " << type_str
+            << " n_db= " << n_db << "\n";
+
+  using bs_t= Bitset2::bitset2<N,T>;
+
+  gen_random_bitset2<N,T>  gen_rand;
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    std::vector<bs_t>  db;
+    db.reserve( n_db );
+    for( size_t i= 0; i < n_db; ++i )
+    {
+      auto bs= gen_rand();
+      // Sparse bitsets produce many equal distances
+      for( size_t a= 0; a < n_and; ++a ) bs &= gen_rand();
+      db.push_back( bs );
+    }
+    auto const  query= gen_rand();
+
+    std::vector<Bitset2::hamming_hit>  all;
+    for( size_t i= 0; i < n_db; ++i )
+                      all.push_back( { i, ( query ^ db[i] ).count() } );
+    std::sort( all.begin(), all.end() );
+
+    for( size_t k: { size_t(0), size_t(1), size_t(7), size_t(100), n_db + 3,
+                     size_t(-1) } )
+    {
+      auto const  n_exp= std::min( k, n_db );
+      std::vector<Bitset2::hamming_hit> const  expct( all.begin(),
+                                                      all.begin() + n_exp );
+      assert( Bitset2::hamming_topk( query, db.data(), n_db, k ) == expct );
+      assert( Bitset2::hamming_topk_mt( query, db.data(), n_db, k, 3 )
+              == expct );
+      assert( Bitset2::hamming_topk_mt( query, db.data(), n_db, k ) == expct );
+#ifdef __cpp_lib_span
+      std::span<bs_t const>  db_span( db );
+      assert( Bitset2::hamming_topk( query, db_span, k ) == expct );
+      assert( Bitset2::hamming_topk_mt( query, db_span, k, 2 ) == expct );
+      assert( Bitset2::hamming_topk( query, std::span( db ), k ) == expct );
+      assert( Bitset2::hamming_topk_mt( query, std::span( db ), k, 2 )
+              == expct );
+      assert( Bitset2::hamming_topk( query, db, k ) == expct );
+#endif
+    }
+  }
+} // test_topk
+
+
+int main()
+{
+  test_topk<64,unsigned long long>(   "U_L_LONG", 50,    0 );
+  test_topk<64,unsigned long long>(   "U_L_LONG", 20000, 3 );
+  test_topk<256,unsigned long long>(  "U_L_LONG", 20000, 0 );
+  test_topk<100,uint8_t>(             "uint8_t",  13000, 2 );
+  test_topk<1024,uint32_t>(           "uint32_t", 9000,  0 );
+} // main
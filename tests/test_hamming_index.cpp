@@ -0,0 +1,116 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks hamming_index::search against a linear scan and times both.
+
+
+#include "../hamming_index.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+
+
+template<size_t N,size_t M,class T>
+void
+test_index( char const * type_str, size_t n_items, size_t max_r )
+{
+  std::cout << "Entering test_index N= " << N << " M= " << M
+            << " type= " << type_str << " n_items= " << n_items << "\n";
+
+  using bs_t= Bitset2::bitset2<N,T>;
+
+  gen_random_bitset2<N,T>             gen_rand;
+  Bitset2::hamming_index<N,M,T>       h_idx;
+  std::vector<bs_t>                   items;
+  for( size_t c= 0; c < n_items; ++c )
+  {
+    // Every 4th item is a near duplicate of a previous one
+    auto bs= ( c % 4 == 3 ) ? items[c / 2] : gen_rand();
+    if( c % 4 == 3 ) for( size_t f= 0; f < c % 7; ++f ) bs.flip( ( c * f ) % N );
+    items.push_back( bs );
+    assert( h_idx.insert( bs ) == c );
+  }
+  assert( h_idx.size() == n_items );
+
+  for( size_t q= 0; q < 50; ++q )
+  {
+    auto query= ( q % 2 == 0 ) ? gen_rand() : items[q * 7 % n_items];
+    if( q % 4 == 1 ) query.flip( q % N ).flip( ( q * 5 ) % N );
+    for( size_t r= 0; r <= max_r; ++r )
+    {
+      std::vector<Bitset2::hamming_hit>  expct;
+      for( size_t c= 0; c < n_items; ++c )
+      {
+        auto const dist= ( query ^ items[c] ).count();
+        if( dist <= r ) expct.push_back( { c, dist } );
+      }
+      std::sort( expct.begin(), expct.end() );
+      assert( h_idx.search( query, r ) == expct );
+    }
+  }
+} // test_index
+
+
+void
+time_search()
+{
+  constexpr size_t N=       64;
+  constexpr size_t n_items= size_t(1) << 20;
+  constexpr size_t r=       3;
+  using ULLONG= unsigned long long;
+  using bs_t=   Bitset2::bitset2<N,ULLONG>;
+
+  gen_random_bitset2<N,ULLONG>         gen_rand;
+  std::vector<bs_t>                    items;
+  for( size_t c= 0; c < n_items; ++c ) items.push_back( gen_rand() );
+  Bitset2::hamming_index<N,4,ULLONG>   h_idx( items.begin(), items.end() );
+
+  std::vector<bs_t>  queries;
+  for( size_t c= 0; c < 100; ++c ) queries.push_back( bs_t( items[c * 997] ).flip( c % N ) );
+
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  size_t n1= 0;
+  for( auto const & q: queries )
+    for( auto const & x: items ) n1 += count_xor( q, x ) <= r;
+
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  size_t n2= 0;
+  for( auto const & q: queries ) n2 += h_idx.search( q, r ).size();
+
+  auto const t3 = std::chrono::high_resolution_clock::now();
+  assert( n1 == n2 );
+
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  const std::chrono::duration<double> dt32 = t3 -t2;
+  std::cout << queries.size() << " queries r= " << r << " over " << n_items
+            << " x bitset2<64>\tlinear scan= " << dt21.count() * 1.0e3 << "ms"
+            << "\thamming_index= " << dt32.count() * 1.0e3 << "ms"
+            << "\t(" << n1 << " hits)\n";
+} // time_search
+
+
+int main()
+{
+  test_index<64,4,unsigned long long>(   "U_L_LONG", 5000, 9 );
+  test_index<64,1,unsigned long long>(   "U_L_LONG", 300,  2 );
+  test_index<64,3,uint32_t>(             "uint32_t", 3000, 7 );
+  test_index<128,8,unsigned long long>(  "U_L_LONG", 3000, 17 );
+  test_index<40,5,uint8_t>(              "uint8_t",  2000, 12 );
+  test_index<64,12,unsigned long long>(  "U_L_LONG", 2000, 14 );
+  test_index<100,7,uint16_t>(            "uint16_t", 2000, 9 );
+#ifdef __SIZEOF_INT128__
+  test_index<128,4,unsigned __int128>(   "uint128",  2000, 10 );
+#endif
+  time_search();
+} // main
@@ -0,0 +1,102 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks lazy expressions against the eager bitset2 operators.
+
+
+#include "../lazy_bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+
+
+constexpr size_t n_loops= 100;
+
+
+using bs70= Bitset2::bitset2<70>;
+
+constexpr
+bs70
+ce_lazy( bs70 const &a, bs70 const &b, bs70 const &c )
+{ return ( Bitset2::lazy( a ) & b ) | ~Bitset2::lazy( c ); }
+
+constexpr bs70  ce_a( 0xF0ull ), ce_b( 0x3Cull ), ce_c( ~bs70( 0xFFull ) );
+
+static_assert( ce_lazy( ce_a, ce_b, ce_c ) == bs70( 0xFFull ), "" );
+static_assert( ( Bitset2::lazy( ce_a ) ^ ce_b ).count() == 4, "" );
+static_assert( ( ~Bitset2::lazy( ce_a ) ).count() == 66, "" );
+static_assert( ( ~Bitset2::lazy( ce_c ) | ce_c ).all(), "" );
+static_assert( Bitset2::difference( Bitset2::lazy( ce_b ), ce_a ).eval().to_ullong() == 0x0Cull, "" );
+static_assert( ( Bitset2::lazy( ce_a ) & ce_c ).none(), "" );
+
+
+template<size_t N,class T,class S>
+void
+test_lazy( char const * type_str )
+{
+  std::cout << "Entering test_lazy N= " << N << " type= " << type_str << "\n";
+
+  using bs_t= Bitset2::bitset2<N,T,S>;
+  using Bitset2::lazy;
+
+  gen_random_bitset2<N,T>  gen_rand;
+  gen_randoms<size_t>      gen_idx( N > 0 ? N - 1 : 0 );
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    bs_t const a( gen_rand().data() );
+    bs_t const b( gen_rand().data() );
+    bs_t const d( gen_rand().data() );
+    bs_t       e( c % 3 == 0 ? bs_t().set() : bs_t( gen_rand().data() ) );
+    bs_t const f( c % 2 == 0 ? bs_t() : bs_t().set( gen_idx() ) );
+
+    auto const la= lazy( a ), lb= lazy( b ), ld= lazy( d ), le= lazy( e );
+
+    bs_t const r1= ( la & lb ) | ( ld & ~le );
+    assert( r1 == ( ( a & b ) | ( d & ~e ) ) );
+    bs_t r2;
+    r2= ( la ^ b ) & ~( lazy( d ) | e );
+    assert( r2 == ( ( a ^ b ) & ~( d | e ) ) );
+    assert( Bitset2::difference( la, lb ).template eval<S>() == Bitset2::difference( a, b ) );
+    assert( ( a | lb ).template eval<S>() == ( a | b ) );
+
+    auto const expr= ~( la | lb ) ^ ~le;
+    bs_t const eager= ~( a | b ) ^ ~e;
+    assert( expr.count() == eager.count() );
+    assert( expr.any()   == eager.any() );
+    assert( expr.none()  == eager.none() );
+    assert( expr.all()   == eager.all() );
+    assert( ( ~le ).all() == e.none() && ( ~le ).none() == e.all() );
+    assert( lazy( f ).any() == f.any() && ( lazy( f ) & e ).any() == ( f & e ).any() );
+    assert( ( ~lazy( f ) ).all() == f.none() );
+
+    // The expression refers to e, changes are visible on evaluation
+    auto const le2= la | le;
+    e.flip();
+    assert( le2.template eval<S>() == ( a | e ) );
+  } // for c
+} // test_lazy
+
+
+int main()
+{
+  test_lazy<1,uint8_t,Bitset2::inline_storage>(              "uint8_t" );
+  test_lazy<65,uint8_t,Bitset2::inline_storage>(             "uint8_t" );
+  test_lazy<100,uint16_t,Bitset2::inline_storage>(           "uint16_t" );
+  test_lazy<130,uint32_t,Bitset2::heap_storage>(             "uint32_t" );
+  test_lazy<1000,unsigned long long,Bitset2::inline_storage>( "U_L_LONG" );
+  test_lazy<4096,unsigned long long,Bitset2::heap_storage>(  "U_L_LONG" );
+#ifdef __SIZEOF_INT128__
+  test_lazy<300,unsigned __int128,Bitset2::inline_storage>(  "uint128" );
+#endif
+} // main
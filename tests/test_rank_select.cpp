@@ -0,0 +1,135 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks rank and select of rank_select_index against bitset2 and
+// times both for a bitset2 with 2^20 bits.
+
+
+#include "../rank_select_index.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <memory>
+
+
+constexpr size_t n_loops= 20;
+
+
+template<size_t N,class T>
+constexpr
+bool
+ce_check()
+{
+  Bitset2::bitset2<N,T>  bs;
+  for( size_t c= 1; c < N; c += c / 3 + 1 ) bs.set( c );
+  Bitset2::rank_select_index<N,T>  rsi( bs );
+  for( size_t c= 0; c <= N; ++c )
+    if( rsi.rank( c ) != bs.rank( c ) ) return false;
+  for( size_t k= 0; k <= bs.count(); ++k )
+    if( rsi.select( k ) != bs.select( k ) ) return false;
+  return rsi.count() == bs.count();
+} // ce_check
+
+
+template<size_t N,class T>
+void
+test_rank_select( char const * type_str, size_t n_and )
+{
+  std::cout << "Entering test_rank_select N= " << N << " type= " << type_str
+            << " n_and= " << n_and << "\n";
+
+  using bs_t=  Bitset2::bitset2<N,T>;
+  using rsi_t= Bitset2::rank_select_index<N,T>;
+
+  gen_random_bitset2<N,T>  gen_rand;
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    auto  bs= std::make_unique<bs_t>( gen_rand() );
+    for( size_t a= 0; a < n_and; ++a ) *bs &= gen_rand();
+    if( c == 0 ) bs->reset();
+    if( c == 1 ) bs->set();
+
+    auto const  rsi= std::make_unique<rsi_t>( *bs );
+    assert( rsi->count() == bs->count() );
+    assert( rsi->rank( N ) == bs->count() );
+    size_t k= 0;
+    for( size_t idx= 0; idx < N; ++idx )
+    {
+      assert( rsi->rank( idx ) == k );
+      if( (*bs)[idx] )
+      {
+        assert( rsi->select( k ) == idx );
+        ++k;
+      }
+    }
+    assert( rsi->select( k ) == rsi_t::npos );
+    assert( k == bs->count() );
+    for( size_t idx= 0; idx <= N; idx += N / 64 + 1 )
+                                     assert( rsi->rank( idx ) == bs->rank( idx ) );
+    for( size_t k2= 0; k2 < k; k2 += k / 64 + 1 )
+                               assert( rsi->select( k2 ) == bs->select( k2 ) );
+  }
+} // test_rank_select
+
+
+void
+time_rank_select()
+{
+  constexpr size_t N=      size_t(1) << 20;
+  constexpr size_t n_qrs=  size_t(1) << 12;
+  using ULLONG= unsigned long long;
+
+  gen_random_bitset2<N,ULLONG>  gen_rand;
+  auto const  bs=  std::make_unique<Bitset2::bitset2<N,ULLONG> >( gen_rand() );
+  auto const  rsi= std::make_unique<Bitset2::rank_select_index<N,ULLONG> >( *bs );
+  auto const  n_set= bs->count();
+
+  auto const t1 = std::chrono::high_resolution_clock::now();
+  size_t sm1= 0;
+  for( size_t c= 0; c < n_qrs; ++c )
+    sm1 += bs->rank( c * 7919 % N ) + bs->select( c * 7919 % n_set );
+
+  auto const t2 = std::chrono::high_resolution_clock::now();
+  size_t sm2= 0;
+  for( size_t c= 0; c < n_qrs; ++c )
+    sm2 += rsi->rank( c * 7919 % N ) + rsi->select( c * 7919 % n_set );
+
+  auto const t3 = std::chrono::high_resolution_clock::now();
+  assert( sm1 == sm2 );
+
+  const std::chrono::duration<double> dt21 = t2 -t1;
+  const std::chrono::duration<double> dt32 = t3 -t2;
+  std::cout << "N= " << N << " " << n_qrs << " rank+select queries"
+            << "\tbitset2= " << dt21.count() * 1.0e3 << "ms"
+            << "\trank_select_index= " << dt32.count() * 1.0e3 << "ms\n";
+} // time_rank_select
+
+
+int main()
+{
+  static_assert( ce_check<200,uint8_t>() );
+  static_assert( ce_check<1100,unsigned long long>() );
+
+  test_rank_select<1,uint8_t>(                    "uint8_t",  0 );
+  test_rank_select<63,uint16_t>(                  "uint16_t", 0 );
+  test_rank_select<512,unsigned long long>(       "U_L_LONG", 0 );
+  test_rank_select<4097,uint8_t>(                 "uint8_t",  3 );
+  test_rank_select<4096,uint32_t>(                "uint32_t", 0 );
+  test_rank_select<70000,unsigned long long>(     "U_L_LONG", 0 );
+  test_rank_select<70000,unsigned long long>(     "U_L_LONG", 6 );
+#ifdef __SIZEOF_INT128__
+  test_rank_select<1000,unsigned __int128>(       "uint128",  1 );
+#endif
+  time_rank_select();
+} // main
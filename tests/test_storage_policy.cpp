@@ -0,0 +1,217 @@
+// BITSET2
+//
+//  Copyright Claas Bontus
+//
+//  Use, modification and distribution is subject to the
+//  Boost Software License, Version 1.0. (See accompanying
+//  file LICENSE.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+// Project home: https://github.com/ClaasBontus/bitset2
+//
+
+
+// Checks bitset2 with heap_storage and arena_storage against inline_storage,
+// as well as the overloads for temporaries.
+
+
+#include "../bitset2.hpp"
+#include "gen_randoms.hpp"
+#include <iostream>
+#include <cassert>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+
+constexpr size_t n_loops= 50;
+
+
+using bs70= Bitset2::bitset2<70>;
+static_assert( ( bs70( 5ull ) | bs70( 2ull ) | bs70( 8ull ) ) == bs70( 15ull ), "" );
+static_assert( Bitset2::rotate_left( ~bs70( 1ull ), 1 ) == ~bs70( 2ull ), "" );
+
+
+/// Bump allocator, deallocate does nothing
+struct bump_arena
+{
+  static size_t  n_allocs;
+  static size_t  n_bytes_used;
+
+  static
+  void *
+  allocate( size_t n_bytes, size_t alignment )
+  {
+    alignas(64) static unsigned char  buffer[1 << 20];
+    auto const start= ( n_bytes_used + alignment - 1 ) / alignment * alignment;
+    if( start + n_bytes > sizeof(buffer) ) throw std::bad_alloc();
+    ++n_allocs;
+    n_bytes_used= start + n_bytes;
+    return buffer + start;
+  }
+
+  static
+  void
+  deallocate( void *, size_t, size_t ) noexcept
+  {}
+}; // struct bump_arena
+
+size_t bump_arena::n_allocs=     0;
+size_t bump_arena::n_bytes_used= 0;
+
+
+template<size_t N,class T,class S>
+void
+test_storage( char const * type_str )
+{
+  std::cout << "Entering test_storage N= " << N << " type= "
+            << type_str << "\n";
+
+  using bs_t=  Bitset2::bitset2<N,T>;
+  using sbs_t= Bitset2::bitset2<N,T,S>;
+
+  auto const is_eq= []( sbs_t const &s, bs_t const &b )
+  { return s.data() == b.data(); };
+
+  gen_random_bitset2<N,T>  gen_rand;
+  gen_randoms<size_t>      gen_idx( 2 * N + 2 );
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    bs_t b1= gen_rand();
+    bs_t b2= gen_rand();
+    if( c == 0 ) b1.reset();
+    if( c == 1 ) b1.set();
+    if( c == 2 ) b2= b1;
+    sbs_t const s1( b1.data() );
+    sbs_t const s2( b2.data() );
+    auto const sh= gen_idx();
+
+    assert( is_eq( s1, b1 ) );
+    assert( sbs_t( b1.to_string() ) == s1 );
+    assert( s1.to_hex_string() == b1.to_hex_string() );
+    assert( s1.count() == b1.count() );
+    assert( s1.find_first() == b1.find_first() );
+    assert( s1.find_last()  == b1.find_last() );
+    assert( Bitset2::stable_hash( s1 ) == Bitset2::stable_hash( b1 ) );
+    assert( std::hash<sbs_t>()( s1 ) == std::hash<bs_t>()( b1 ) );
+
+    assert( is_eq( ~s1, ~b1 ) );
+    assert( is_eq( s1 & s2, b1 & b2 ) );
+    assert( is_eq( s1 | s2, b1 | b2 ) );
+    assert( is_eq( s1 ^ s2, b1 ^ b2 ) );
+    assert( is_eq( s1 + s2, b1 + b2 ) );
+    assert( is_eq( s1 << sh, b1 << sh ) );
+    assert( is_eq( s1 >> sh, b1 >> sh ) );
+    assert( is_eq( Bitset2::difference( s1, s2 ), Bitset2::difference( b1, b2 ) ) );
+    assert( is_eq( Bitset2::rotate_left( s1, sh ),  Bitset2::rotate_left( b1, sh ) ) );
+    assert( is_eq( Bitset2::rotate_right( s1, sh ), Bitset2::rotate_right( b1, sh ) ) );
+    assert( is_eq( Bitset2::reverse( s1 ),     Bitset2::reverse( b1 ) ) );
+    assert( is_eq( Bitset2::complement2( s1 ), Bitset2::complement2( b1 ) ) );
+    assert( is_eq( Bitset2::midpoint( s1, s2 ), Bitset2::midpoint( b1, b2 ) ) );
+    assert( is_eq( Bitset2::midpoint( s1, s2, true ),
+                   Bitset2::midpoint( b1, b2, true ) ) );
+    assert( Bitset2::count_xor( s1, s2 ) == Bitset2::count_xor( b1, b2 ) );
+    assert( ( s1 == s2 ) == ( b1 == b2 ) );
+    assert( ( s1 <  s2 ) == ( b1 <  b2 ) );
+
+    // Overloads for temporaries
+    assert( is_eq( sbs_t( s1 ) | s2,         b1 | b2 ) );
+    assert( is_eq( s1 & sbs_t( s2 ),         b1 & b2 ) );
+    assert( is_eq( sbs_t( s1 ) ^ sbs_t( s2 ), b1 ^ b2 ) );
+    assert( is_eq( ~sbs_t( s1 ),             ~b1 ) );
+    assert( is_eq( ( ( s1 | s2 ) & ~( s1 ^ s2 ) ) | ( s1 & s2 ),
+                   ( ( b1 | b2 ) & ~( b1 ^ b2 ) ) | ( b1 & b2 ) ) );
+    assert( ( bs_t( b1 ) | b2 ) == ( b1 | b2 ) && ( b1 ^ bs_t( b2 ) ) == ( b1 ^ b2 ) );
+    assert( is_eq( Bitset2::difference( sbs_t( s1 ), s2 ),
+                   Bitset2::difference( bs_t( b1 ), b2 ) ) );
+    assert( is_eq( Bitset2::rotate_left( sbs_t( s1 ), sh ),
+                   Bitset2::rotate_left( bs_t( b1 ), sh ) ) );
+    assert( is_eq( Bitset2::rotate_right( sbs_t( s1 ), sh ),
+                   Bitset2::rotate_right( bs_t( b1 ), sh ) ) );
+    assert( is_eq( Bitset2::reverse( sbs_t( s1 ) ), Bitset2::reverse( bs_t( b1 ) ) ) );
+
+    auto s3= s1;
+    auto b3= b1;
+    assert( is_eq( s3++, b3++ ) && is_eq( s3, b3 ) );
+    s3.rotate_right( sh );
+    b3.rotate_right( sh );
+    assert( is_eq( s3, b3 ) );
+    s3[N / 2]= !s3[N / 2];
+    b3[N / 2]= !b3[N / 2];
+    assert( is_eq( s3, b3 ) );
+
+    // Moving hands over the words, assigning to a moved-from object works
+    auto const ptr= s3.data().data();
+    auto s4= std::move( s3 );
+    assert( s4.data().data() == ptr );
+    s3= s1;
+    assert( is_eq( s3, b1 ) );
+    s3= std::move( s4 );
+    assert( s3.data().data() == ptr && is_eq( s3, b3 ) );
+    assert( is_eq( s4, b1 ) );
+  } // for c
+} // test_storage
+
+
+/// Operations on a 2 MB bitset2, which would overflow some threads' stacks
+void
+test_large()
+{
+  std::cout << "Entering test_large\n";
+
+  constexpr size_t n_bits= size_t(1) << 24;
+  using hbs_t= Bitset2::bitset2<n_bits,uint64_t,Bitset2::heap_storage>;
+
+  static_assert( sizeof(hbs_t) == sizeof(void*), "" );
+  hbs_t  b1( 0xF0F0ull );
+  hbs_t  b2;
+  b2.set( n_bits - 1 );
+  auto b3= b1 | b2;
+  assert( b3.count() == 9 );
+  b3= ~b3;
+  assert( b3.count() == n_bits - 9 );
+  b3.rotate_left( 12345 );
+  assert( b3.count() == n_bits - 9 );
+  b3.rotate_right( 12345 );
+  assert( ( b3 | b1 | b2 ).all() && Bitset2::count_and( b3, b1 ) == 0 );
+  auto const b4= Bitset2::reverse( b1 << 100 );
+  assert( b4.find_first() == n_bits - 116 && b4.count() == 8 );
+} // test_large
+
+
+/// Copies allocate from the arena, moves do not
+void
+test_arena()
+{
+  std::cout << "Entering test_arena\n";
+
+  using abs_t= Bitset2::bitset2<1000,uint32_t,Bitset2::arena_storage<bump_arena> >;
+
+  auto const n0= bump_arena::n_allocs;
+  abs_t  a1( 12345ull );
+  abs_t  a2= a1;
+  assert( bump_arena::n_allocs == n0 + 2 );
+  abs_t  a3= std::move( a2 );
+  a2= std::move( a1 );
+  assert( bump_arena::n_allocs == n0 + 2 );
+  assert( a2 == a3 && a3.to_ullong() == 12345ull );
+  auto const a4= a2 ^ a3;
+  assert( a4.none() && bump_arena::n_allocs == n0 + 3 );
+  assert( reinterpret_cast<uintptr_t>( a4.data().data() ) % alignof(uint32_t) == 0 );
+} // test_arena
+
+
+int main()
+{
+  test_storage<1,uint8_t,Bitset2::heap_storage>(                 "uint8_t" );
+  test_storage<65,uint8_t,Bitset2::heap_storage>(                "uint8_t" );
+  test_storage<100,uint16_t,Bitset2::heap_storage>(              "uint16_t" );
+  test_storage<130,uint32_t,Bitset2::arena_storage<bump_arena> >( "uint32_t" );
+  test_storage<1000,unsigned long long,Bitset2::heap_storage>(   "U_L_LONG" );
+  test_storage<4096,unsigned long long,Bitset2::heap_storage>(   "U_L_LONG" );
+#ifdef __SIZEOF_INT128__
+  test_storage<300,unsigned __int128,Bitset2::heap_storage>(     "uint128" );
+#endif
+  test_large();
+  test_arena();
+} // main
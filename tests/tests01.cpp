@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <iostream>
 #include <chrono>
+#include <algorithm>
 
 #define TESTMANY(F) \
     F <7  >(); \
@@ -53,10 +54,18 @@
     F <256,T>(S); \
     F <257,T>(S);
 
+#define TESTLARGE2(F,T,S) \
+    F <1000, T>(S); \
+    F <4096, T>(S); \
+    F <4161, T>(S); \
+    F <65536,T>(S);
+
 #ifdef __SIZEOF_INT128__
 # define USE128(F) TESTMANY2(F,unsigned __int128,"uint128")
+# define USE128L(F) TESTLARGE2(F,unsigned __int128,"uint128")
 #else
 # define USE128(F)
+# define USE128L(F)
 #endif
 
 #define TESTMNY(F) { \
@@ -72,6 +81,18 @@
     }
 
 
+#define TESTLRG(F) { \
+    auto const t1 = std::chrono::high_resolution_clock::now(); \
+    TESTLARGE2(F,uint8_t, "uint8_t" ) \
+    TESTLARGE2(F,uint32_t,"uint32_t") \
+    TESTLARGE2(F,unsigned long long,"U_L_LONG") \
+    USE128L(F) \
+    auto const t2 = std::chrono::high_resolution_clock::now(); \
+    const std::chrono::duration<double> dt21 = t2 -t1; \
+    std::cout << "Total: " << dt21.count() << " seconds\n\n"; \
+    }
+
+
 template<size_t N,class T=unsigned long long>
 using t1= Bitset2::bitset2<N,T>;
 
@@ -316,6 +337,8 @@ test_rotate( char const * type_str )
   constexpr t1<74,T>  ce_bs1_r= Bitset2::rotate_left( ce_bs1, 1 );
   constexpr t1<74,T>  ce_bs2( ce_arr2 );
   static_assert( ce_bs1_r == ce_bs2, "" );
+  static_assert( t1<74,T>( ce_bs1 ).template rotate_left<1>() == ce_bs2, "" );
+  static_assert( t1<74,T>( ce_bs2 ).template rotate_right<75>() == ce_bs1, "" );
 
   gen_random_bitset2<N,T>  gen_rand;
   for( size_t c= 0; c < n_loops; ++c )
@@ -352,7 +375,28 @@ test_rotate( char const * type_str )
       assert( bc1_c1 == bs2_l );
       assert( bc1_c2 == bs2_r );
     }
+
+    auto bc1_c3= bs1;
+    auto bc1_c4= bs1;
+    assert( bc1_c3.template rotate_left<1>()       == Bitset2::rotate_left( bs1, 1 ) );
+    assert( bc1_c3.template rotate_left<N + 4>()   == Bitset2::rotate_left( bs1, 5 ) );
+    assert( bc1_c4.template rotate_right<N / 2>()  == Bitset2::rotate_right( bs1, N / 2 ) );
+    assert( bc1_c4.template rotate_right<2 * N>()  == Bitset2::rotate_right( bs1, N / 2 ) );
   } // for c
+
+  // Rotations by more than the bits kept on the stack in either direction
+  constexpr size_t  n_lrg= 5000;
+  gen_random_bitset2<n_lrg,T>  gen_rand_lrg;
+  auto const  bs_lrg= gen_rand_lrg();
+  for( size_t b_c: { size_t(2100), size_t(2500 + N), size_t(2900 - N) } )
+  {
+    auto bc_l= bs_lrg;
+    auto bc_r= bs_lrg;
+    bc_l.rotate_left(  b_c );
+    bc_r.rotate_right( b_c );
+    assert( bc_l == ( ( bs_lrg << b_c ) | ( bs_lrg >> ( n_lrg - b_c ) ) ) );
+    assert( bc_r == ( ( bs_lrg >> b_c ) | ( bs_lrg << ( n_lrg - b_c ) ) ) );
+  }
 } // test_rotate
 
 
@@ -378,6 +422,10 @@ test_shift( char const * type_str )
   constexpr t1<74,T>  ce_bs3( ce_arr3 );
   static_assert( ce_bs1_s1 == ce_bs2, "" );
   static_assert( ce_bs1_s2 == ce_bs3, "" );
+  static_assert( t1<74,T>( ce_bs1 ).template shift_left<1>() == ce_bs2, "" );
+  static_assert( t1<74,T>( ce_bs1 ).template shift_right<1>() == ce_bs3, "" );
+  static_assert( t1<74,T>( ce_bs1 ).shift_left( typename t1<74,T>::shift_plan( 1 ) )
+                 == ce_bs2, "" );
 
   for( size_t c= 0; c < n_loops; ++c )
   {
@@ -391,6 +439,11 @@ test_shift( char const * type_str )
       auto       bs1_c2= bs1;
       bs1_c1 <<= b_c;
       bs1_c2 >>= b_c;
+      typename t1<N,T>::shift_plan const plan( b_c );
+      auto       bs1_c3= bs1;
+      auto       bs1_c4= bs1;
+      assert( bs1_c3.shift_left( plan )  == bs1_l );
+      assert( bs1_c4.shift_right( plan ) == bs1_r );
       if( verbose )
         std::cout << bs1 << "\t"
                   << bs1_l << "\t"
@@ -413,6 +466,16 @@ test_shift( char const * type_str )
         assert( bs1_c2 == empty1 );
       }
     } // for b_c
+
+    auto bs1_c5= bs1;
+    auto bs1_c6= bs1;
+    assert( bs1_c5.template shift_left<1>()      == ( bs1 << 1 ) );
+    assert( bs1_c6.template shift_right<1>()     == ( bs1 >> 1 ) );
+    assert( bs1_c5.template shift_left<N / 2>()  == ( bs1 << ( N / 2 + 1 ) ) );
+    assert( bs1_c6.template shift_right<N / 2>() == ( bs1 >> ( N / 2 + 1 ) ) );
+    bs1_c5= bs1;
+    assert( bs1_c5.template shift_left<64>()     == ( bs1 << 64 ) );
+    assert( bs1_c5.template shift_right<N>()     == empty1 );
   } // for c
 } // test_shift
 
@@ -553,6 +616,209 @@ test_difference( char const * type_str )
 
 
 
+/// Checks bitwise_ternary<imm> against the truth table bit by bit
+template<uint8_t imm,size_t N,class T>
+bool
+ternary_per_bit( t1<N,T> const &bs1, t1<N,T> const &bs2, t1<N,T> const &bs3 )
+{
+  auto const r= Bitset2::bitwise_ternary<imm>( bs1, bs2, bs3 );
+  for( size_t b_c= 0; b_c < N; ++b_c )
+  {
+    auto const idx= 4 * bs1[b_c] + 2 * bs2[b_c] + bs3[b_c];
+    if( r[b_c] != ( ( imm >> idx ) & 1 ) ) return false;
+  }
+  return r.count() <= N;
+}
+
+
+template<size_t N,class T>
+void
+test_ternary( char const * type_str )
+{
+  std::cout << "Entering test_ternary N= " << N << " type= " << type_str << "\n";
+
+  constexpr std::array<T,2>  ce_arr1{{ T(3), T(5) }};
+  constexpr std::array<T,2>  ce_arr2{{ T(6), T(1) }};
+  constexpr std::array<T,2>  ce_arr3{{ T(12), T(9) }};
+  constexpr t1<74,T>  ce_bs1( ce_arr1 );
+  constexpr t1<74,T>  ce_bs2( ce_arr2 );
+  constexpr t1<74,T>  ce_bs3( ce_arr3 );
+  static_assert( Bitset2::bitwise_ternary<0xCA>( ce_bs1, ce_bs2, ce_bs3 )
+                 == ( ( ce_bs1 & ce_bs2 ) | ( ~ce_bs1 & ce_bs3 ) ), "" );
+  static_assert( Bitset2::bitwise_ternary<0x01>( ce_bs1, ce_bs2, ce_bs3 )
+                 == ~( ce_bs1 | ce_bs2 | ce_bs3 ), "" );
+
+  gen_random_bitset2<N,T>  gen_rand;
+
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    auto const  bs1=  gen_rand();
+    auto const  bs2=  gen_rand();
+    auto const  bs3=  gen_rand();
+    auto        bs4=  bs1;
+
+    assert( ( Bitset2::bitwise_ternary<0xCA>( bs1, bs2, bs3 )
+              == ( ( bs1 & bs2 ) | ( ~bs1 & bs3 ) ) ) );
+    assert( ( Bitset2::bitwise_ternary<0xE8>( bs1, bs2, bs3 )
+              == ( ( bs1 & bs2 ) | ( bs1 & bs3 ) | ( bs2 & bs3 ) ) ) );
+    assert( ( Bitset2::bitwise_ternary<0xBA>( bs1, bs2, bs3 )
+              == ( difference( bs1, bs2 ) | bs3 ) ) );
+    assert( ( Bitset2::bitwise_ternary<0x96>( bs1, bs2, bs3 ) == ( bs1 ^ bs2 ^ bs3 ) ) );
+    assert( ( Bitset2::bitwise_ternary<0x00>( bs1, bs2, bs3 ).none() ) );
+    assert( ( Bitset2::bitwise_ternary<0xFF>( bs1, bs2, bs3 ).all() ) );
+    bs4.template bitwise_ternary<0x78>( bs2, bs3 );
+    assert( bs4 == ( bs1 ^ ( bs2 & bs3 ) ) );
+
+    if( c < 8 )
+    {
+      assert( ( ternary_per_bit<0x01>( bs1, bs2, bs3 ) ) );
+      assert( ( ternary_per_bit<0x2D>( bs1, bs2, bs3 ) ) );
+      assert( ( ternary_per_bit<0x5B>( bs1, bs2, bs3 ) ) );
+      assert( ( ternary_per_bit<0xB4>( bs1, bs2, bs3 ) ) );
+      assert( ( ternary_per_bit<0xD3>( bs1, bs2, bs3 ) ) );
+    }
+  } // for c
+} // test_ternary
+
+
+
+template<size_t N,class T>
+void
+test_extract_deposit( char const * type_str )
+{
+  std::cout << "Entering test_extract_deposit N= " << N << " type= " << type_str << "\n";
+
+  constexpr t1<74,T>  ce_src( 0xB6ull );
+  constexpr t1<74,T>  ce_mask( ( t1<74,T>( 0xF0ull ) << 66 ) | t1<74,T>( 0x3Cull ) );
+  static_assert( extract_bits( ce_src, ce_mask ) == t1<74,T>( 0x0Dull ), "" );
+  static_assert( deposit_bits( ce_src, ce_mask )
+                 == ( ( t1<74,T>( 0xB0ull ) << 66 ) | t1<74,T>( 0x18ull ) ), "" );
+
+  gen_random_bitset2<N,T>  gen_rand;
+
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    auto const  bs1=  gen_rand();
+    auto const  msk=  c % 3 == 0 ? gen_rand() & gen_rand() & gen_rand()
+                    : c % 3 == 1 ? gen_rand() : ~t1<N,T>();
+    auto const  n_m=  msk.count();
+
+    auto const  ex=   extract_bits( bs1, msk );
+    auto const  dp=   deposit_bits( bs1, msk );
+    assert( deposit_bits( ex, msk ) == ( bs1 & msk ) );
+    assert( extract_bits( dp, msk ) == ( n_m == N ? bs1
+                                         : bs1 & ~( ~t1<N,T>() << n_m ) ) );
+    if( c < 8 )
+    {
+      size_t k= 0;
+      for( size_t b_c= 0; b_c < N; ++b_c )
+      {
+        if( !msk[b_c] ) { assert( !dp[b_c] ); continue; }
+        assert( ex[k] == bs1[b_c] );
+        assert( dp[b_c] == bs1[k] );
+        ++k;
+      }
+      assert( ex.count() <= n_m && ( n_m == N || ( ex >> n_m ).none() ) );
+    }
+  } // for c
+} // test_extract_deposit
+
+
+
+template<size_t N,class T>
+void
+test_range( char const * type_str )
+{
+  std::cout << "Entering test_range N= " << N << " type= " << type_str << "\n";
+
+  constexpr auto ce_bs1= t1<74,T>().set_range( 3, 70 ).flip_range( 60, 74 );
+  static_assert( ce_bs1.count() == 61 && ce_bs1.count_range( 62, 74 ) == 4, "" );
+  static_assert( !ce_bs1.any_in_range( 60, 70 ) && ce_bs1.any_in_range( 0, 4 ), "" );
+  static_assert( t1<74,T>( ce_bs1 ).reset_range( 0, 74 ).none(), "" );
+
+  gen_random_bitset2<N,T>  gen_rand;
+  gen_randoms<size_t>      gen_idx( N );
+
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    auto const  bs1=  gen_rand();
+    auto        lo=   gen_idx();
+    auto        hi=   c % 4 == 0 ? std::min( N, lo + gen_idx() % 70 ) : gen_idx();
+    if( lo > hi ) std::swap( lo, hi );
+
+    t1<N,T> rng;
+    for( size_t b_c= lo; b_c < hi; ++b_c ) rng.set( b_c );
+
+    auto bs2= bs1;
+    assert( bs2.set_range( lo, hi )   == ( bs1 | rng ) );
+    bs2= bs1;
+    assert( bs2.reset_range( lo, hi ) == difference( bs1, rng ) );
+    bs2= bs1;
+    assert( bs2.flip_range( lo, hi )  == ( bs1 ^ rng ) );
+    assert( bs1.count_range( lo, hi )  == count_and( bs1, rng ) );
+    assert( bs1.any_in_range( lo, hi ) == ( count_and( bs1, rng ) > 0 ) );
+    assert( !bs1.any_in_range( lo, lo ) && bs1.count_range( hi, hi ) == 0 );
+  } // for c
+} // test_range
+
+
+
+/// Compares extract<M> and insert against shifts and convert_to
+template<size_t M,size_t N,class T>
+void
+check_field( t1<N,T> const &bs, t1<M,T> const &field, size_t pos )
+{
+  if constexpr( M <= N )
+  {
+    pos %= N - M + 1;
+    assert( bs.template extract<M>( pos ) == Bitset2::convert_to<M>( bs >> pos ) );
+    auto const mask= Bitset2::convert_to<N>( ~t1<M,T>() ) << pos;
+    auto bs2= bs;
+    bs2.insert( pos, field );
+    assert( bs2 == ( difference( bs, mask ) | ( Bitset2::convert_to<N>( field ) << pos ) ) );
+    assert( bs2.template extract<M>( pos ) == field );
+  }
+} // check_field
+
+
+template<size_t N,class T>
+void
+test_extract_insert( char const * type_str )
+{
+  std::cout << "Entering test_extract_insert N= " << N << " type= " << type_str << "\n";
+
+  constexpr t1<74,T> ce_bs1( 0xABCDull );
+  static_assert( ce_bs1.template extract<8,4>() == t1<8,T>( 0xBCull ), "" );
+  static_assert( ce_bs1.template extract<70>( 4 ) == t1<70,T>( 0xABCull ), "" );
+  static_assert( t1<74,T>( ce_bs1 ).template insert<66>( t1<8,T>( 0xFFull ) ).count()
+                 == ce_bs1.count() + 8, "" );
+  static_assert( t1<74,T>().insert( 60, ~t1<14,T>() ).count_range( 60, 74 ) == 14, "" );
+
+  gen_random_bitset2<N,T>  gen_rand;
+  gen_random_bitset2<70,T> gen_rand70;
+  gen_randoms<size_t>      gen_idx( N );
+
+  for( size_t c= 0; c < n_loops; ++c )
+  {
+    auto const  bs1=  gen_rand();
+    auto const  bs2=  gen_rand70();
+    auto const  pos=  gen_idx();
+    check_field<1>(  bs1, Bitset2::convert_to<1>( bs2 ),  pos );
+    check_field<7>(  bs1, Bitset2::convert_to<7>( bs2 ),  pos );
+    check_field<16>( bs1, Bitset2::convert_to<16>( bs2 ), pos );
+    check_field<64>( bs1, Bitset2::convert_to<64>( bs2 ), pos );
+    check_field<70>( bs1, bs2,                            pos );
+    check_field<N>(  bs1, gen_rand(),                     pos );
+  } // for c
+
+  bool thrown= false;
+  try { (void)t1<N,T>().template extract<2>( N - 1 ); }
+  catch( std::out_of_range const & ) { thrown= true; }
+  assert( thrown );
+} // test_extract_insert
+
+
+
 
 
 template<size_t N,class T>
@@ -588,6 +854,39 @@ idx_lst( t1<N,T> const &bs )
 
 
 
+template<size_t N,class T>
+constexpr
+size_t
+ce_sum_set_bits( t1<N,T> const &bs, bool rev )
+{
+  size_t ret_val= 0, prev= 0, ct= 0;
+  if( rev )
+  {
+    for( auto idx: bs.set_bits_reverse() )
+    { if( ct++ > 0 && idx >= prev ) return 0; ret_val += idx; prev= idx; }
+  }
+  else
+  {
+    for( auto idx: bs.set_bits() )
+    { if( ct++ > 0 && idx <= prev ) return 0; ret_val += idx; prev= idx; }
+  }
+  return ret_val;
+} // ce_sum_set_bits
+
+
+template<size_t N,class T>
+constexpr
+size_t
+ce_sum_decoded( t1<N,T> const &bs )
+{
+  uint32_t  buf[N]{};
+  size_t    ret_val= 0;
+  auto const n= bs.decode_positions( buf );
+  for( size_t c= 0; c < n; ++c ) ret_val += buf[c];
+  return ret_val;
+} // ce_sum_decoded
+
+
 template<size_t N,class T>
 void
 test_find( char const * type_str )
@@ -604,6 +903,23 @@ test_find( char const * type_str )
   static_assert( ce_bs2.find_next_zero( 2 ) == 3, "" );
   static_assert( ce_bs1.find_next( 3 ) == t1<N,T>::npos, "" );
   static_assert( ce_bs2.find_next_zero( 3 ) == t1<N,T>::npos, "" );
+  static_assert( ce_sum_set_bits( ce_bs1, false ) == 5, "" );
+  static_assert( ce_sum_set_bits( ce_bs1, true ) == 5, "" );
+  static_assert( ce_sum_set_bits( ce_bs2, false ) == N * (N-1) / 2 - 5, "" );
+  static_assert( ce_sum_set_bits( ce_bs2, true ) == N * (N-1) / 2 - 5, "" );
+  static_assert( ce_sum_set_bits( t1<N,T>(), true ) == 0, "" );
+  static_assert( ce_sum_decoded( ce_bs2 ) == N * (N-1) / 2 - 5, "" );
+  static_assert( ce_bs1.rank( 0 ) == 0 && ce_bs1.rank( 3 ) == 1, "" );
+  static_assert( ce_bs1.rank( N ) == 2 && ce_bs2.rank( N ) == N - 2, "" );
+  static_assert( ce_bs1.select( 0 ) == 2 && ce_bs1.select( 1 ) == 3, "" );
+  static_assert( ce_bs1.select( 2 ) == t1<N,T>::npos, "" );
+  static_assert( ce_bs2.select( 2 ) == 4 && ce_bs2.select( N-3 ) == N-1, "" );
+#ifdef __cpp_lib_ranges
+  static_assert( std::ranges::view<decltype( ce_bs1.set_bits() )> );
+  static_assert( std::ranges::forward_range<decltype( ce_bs1.set_bits() )> );
+  static_assert( std::ranges::borrowed_range<decltype( ce_bs1.set_bits() )> );
+  static_assert( std::ranges::distance( ce_bs2.set_bits_reverse() ) == N - 2 );
+#endif
 
   gen_random_bitset2<N,T>  gen_rand;
 
@@ -654,6 +970,41 @@ test_find( char const * type_str )
   {
     auto const  bs1=  gen_rand();
     auto const  lst=  idx_lst( bs1 );
+    std::vector<size_t>  lst2, lst3;
+    for( auto idx: bs1.set_bits() ) lst2.push_back( idx );
+    for( auto idx: bs1.set_bits_reverse() ) lst3.push_back( idx );
+    assert( lst2 == lst );
+    assert( std::equal( lst3.rbegin(), lst3.rend(), lst.begin(), lst.end() ) );
+    std::vector<uint32_t>  pos32( lst.size() + 1, 0 );
+    std::vector<uint16_t>  pos16( lst.size() + 1, 0 );
+    assert( bs1.decode_positions( pos32.data() ) == lst.size() );
+    assert( bs1.decode_positions( pos16.data() ) == lst.size() );
+    assert( std::equal( lst.begin(), lst.end(), pos32.begin() ) );
+    assert( std::equal( lst.begin(), lst.end(), pos16.begin() ) );
+    assert( pos32.back() == 0 && pos16.back() == 0 );
+    for( size_t k= 0; k < lst.size(); ++k )
+    {
+      assert( bs1.select( k ) == lst[k] );
+      assert( bs1.rank( lst[k] ) == k );
+      assert( bs1.rank( lst[k] + 1 ) == k + 1 );
+    }
+    assert( bs1.select( lst.size() ) == (Bitset2::bitset2<N,T>::npos) );
+    assert( bs1.rank( N ) == lst.size() );
+#ifdef __cpp_lib_span
+    auto const  n_part= lst.size() / 2;
+    std::fill( pos32.begin(), pos32.end(), uint32_t(0) );
+    assert( bs1.decode_positions( std::span<uint32_t>( pos32.data(), n_part ) )
+            == n_part );
+    assert( std::equal( pos32.begin(), pos32.begin() + n_part, lst.begin() ) );
+    assert( pos32[n_part] == 0 );
+    std::fill( pos16.begin(), pos16.end(), uint16_t(0) );
+    assert( bs1.decode_positions( pos16 ) == lst.size() );
+    assert( std::equal( lst.begin(), lst.end(), pos16.begin() ) );
+    std::array<uint32_t,4>  pos_fx{};
+    auto const  n_fx= std::min( lst.size(), pos_fx.size() );
+    assert( bs1.decode_positions( std::span( pos_fx ) ) == n_fx );
+    assert( std::equal( pos_fx.begin(), pos_fx.begin() + n_fx, lst.begin() ) );
+#endif
     if( lst.empty() )
     {
         assert( bs1.find_first() == (Bitset2::bitset2<N,T>::npos) );
@@ -703,6 +1054,12 @@ test_bitwise_ops( char const * type_str )
   static_assert( ce_or  == ce_bs_e_or,  "" );
   static_assert( ce_and == ce_bs_e_and, "" );
   static_assert( ce_xor == ce_bs_e_xor, "" );
+  static_assert( count_and( ce_bs1, ce_bs2 ) == ce_and.count(), "" );
+  static_assert( count_or( ce_bs1, ce_bs2 )  == ce_or.count(),  "" );
+  static_assert( count_xor( ce_bs1, ce_bs2 ) == ce_xor.count(), "" );
+  static_assert( count_difference( ce_bs1, ce_bs2 )
+                 == difference( ce_bs1, ce_bs2 ).count(), "" );
+  static_assert( count_xor( ce_bs1, ce_bs2 ) > 0, "" );
 
   gen_random_bitset2<N,T>  gen_rand;
 
@@ -729,6 +1086,10 @@ test_bitwise_ops( char const * type_str )
     assert( sb_or  == t2<N>( b_or ) );
     assert( sb_and == t2<N>( b_and ) );
     assert( sb_xor == t2<N>( b_xor ) );
+    assert( count_or( bs1, bs2 )  == sb_or.count() );
+    assert( count_and( bs1, bs2 ) == sb_and.count() );
+    assert( count_xor( bs1, bs2 ) == sb_xor.count() );
+    assert( count_difference( bs1, bs2 ) == ( sbs1 & ~sbs2 ).count() );
   } // for c
 } // test_bitwise_ops
 
@@ -745,6 +1106,9 @@ test_reverse( char const * type_str )
   constexpr auto     ce_bs1_rev= Bitset2::reverse( ce_bs1 );
   constexpr auto     ce_bs1_rot= Bitset2::rotate_right( ce_bs1, 2 );
   static_assert( ce_bs1_rev == ce_bs1_rot, "" );
+  static_assert( t1<N,T>( ce_bs1 ).reverse() == ce_bs1_rev, "" );
+  static_assert( t1<N,T>( ce_bs1 ).rotate_left( N / 2 ).rotate_left( N - N / 2 )
+                 == ce_bs1, "" );
 
   gen_random_bitset2<N,T>  gen_rand;
 
@@ -835,6 +1199,11 @@ test_compare( char const * type_str )
   static_assert( ce_bs2  >  ce_bs2a,  "" );
   static_assert( ce_bs2a >= ce_bs2b, "" );
   static_assert( ce_bs2a != ce_bs2,  "" );
+#ifdef __cpp_lib_three_way_comparison
+  static_assert( ( ce_bs2a <=> ce_bs2 )  < 0 );
+  static_assert( ( ce_bs2  <=> ce_bs2a ) > 0 );
+  static_assert( ( ce_bs2b <=> ce_bs2a ) == 0 );
+#endif
 
   gen_random_bitset2<N,T>  gen_rand;
 
@@ -857,6 +1226,14 @@ test_compare( char const * type_str )
     }
     assert( bs3 <= bs1 );
     assert( bs3 >= bs1 );
+#ifdef __cpp_lib_three_way_comparison
+    assert( ( bs3 <=> bs1 ) == 0 );
+    if( bs1 != ce_bs1 )
+    {
+      assert( ( bs2 <=> bs1 ) < 0 );
+      assert( ( bs1 <=> bs2 ) > 0 );
+    }
+#endif
   } // for c
 } // test_compare
 
@@ -902,6 +1279,88 @@ test_complement2( char const * type_str )
 
 
 
+/// Large N, such that the runtime kernels get used
+template<size_t N,class T>
+void
+test_large( char const * type_str )
+{
+  std::cout << "Entering test_large N= " << N << " type= " << type_str << "\n";
+
+  using a_f= Bitset2::detail::array_funcs<t1<N,T>::n_array,T>;
+
+  gen_random_bitset2<N,T>  gen_rand;
+  for( size_t c= 0; c < n_loops / 100; ++c )
+  {
+    auto const  bs1= gen_rand();
+    auto const  bs2= gen_rand();
+    auto const  sb1= t2<N>( bs1 );
+    auto const  sb2= t2<N>( bs2 );
+
+    assert( bs1.count() == sb1.count() );
+    assert( bs1.count() == a_f().count_impl( bs1.data() ) );
+
+    auto const  bs_sprs= bs1 & bs2 & gen_rand();
+    std::vector<uint32_t>  pos1( N ), pos2( N );
+    auto const  n_pos= bs_sprs.decode_positions( pos1.data() );
+    assert( n_pos == bs_sprs.count() );
+    assert( n_pos == a_f().decode_positions_impl( bs_sprs.data(),
+                                                  pos2.data(), N ) );
+    assert( pos1 == pos2 );
+    assert( bs1.decode_positions( pos1.data() ) == bs1.count() );
+    size_t  ct_pos= 0;
+    for( auto idx: bs1.set_bits() ) assert( pos1[ct_pos++] == idx );
+
+    auto bs_or=  bs1;
+    auto bs_and= bs1;
+    auto bs_xor= bs1;
+    auto bs_sd=  bs1;
+    bs_or  |= bs2;
+    bs_and &= bs2;
+    bs_xor ^= bs2;
+    bs_sd.difference( bs2 );
+    assert( t2<N>( bs_or )  == ( sb1 | sb2 ) );
+    assert( t2<N>( bs_and ) == ( sb1 & sb2 ) );
+    assert( t2<N>( bs_xor ) == ( sb1 ^ sb2 ) );
+    assert( t2<N>( bs_sd )  == ( sb1 & ~sb2 ) );
+    assert( ( bs1 | bs2 ) == bs_or );
+    assert( ( bs1 & bs2 ) == bs_and );
+    assert( ( bs1 ^ bs2 ) == bs_xor );
+    assert( Bitset2::difference( bs1, bs2 ) == bs_sd );
+    assert( bs_xor.count() == ( sb1 ^ sb2 ).count() );
+    assert( count_or( bs1, bs2 )  == bs_or.count() );
+    assert( count_and( bs1, bs2 ) == bs_and.count() );
+    assert( count_xor( bs1, bs2 ) == bs_xor.count() );
+    assert( count_difference( bs1, bs2 ) == bs_sd.count() );
+
+    // Strings start with the most significant bit
+    auto const  str1= sb1.to_string();
+    auto const  str2= sb2.to_string();
+    assert( ( bs1 <  bs2 ) == ( str1 <  str2 ) );
+    assert( ( bs1 >  bs2 ) == ( str1 >  str2 ) );
+    assert( ( bs1 == bs2 ) == ( str1 == str2 ) );
+    assert( bs1.none() == sb1.none() );
+
+    size_t const pos= ( c * 7919 + 13 ) % N;
+    auto         bs3= bs1;
+    bs3.flip( pos );
+    assert( bs3 != bs1 );
+    assert( ( bs3 < bs1 ) == !bs3[pos] );
+    assert( ( bs1 < bs3 ) ==  bs3[pos] );
+    assert( bs_and.difference( bs2 ).none() );
+    t1<N,T>      bs4;
+    assert( bs4.none() );
+    bs4.set( pos );
+    assert( !bs4.none() );
+#ifdef __cpp_lib_three_way_comparison
+    assert( ( bs1 <=> bs2 ) == ( str1 <=> str2 ) );
+    assert( ( ( bs3 <=> bs1 ) < 0 ) == !bs3[pos] );
+    assert( ( bs1 <=> bs1 ) == 0 );
+#endif
+  } // for c
+} // test_large
+
+
+
 template<size_t N>
 void
 test_hash()
@@ -973,10 +1432,47 @@ test_hash()
     assert( hs1_64 == hs2_64 );
     assert( hs1_64 == hs3_64 );
     assert( hs1_64 == hs4_64 );
+
+    assert( Bitset2::stable_hash( bs1_64 ) == Bitset2::stable_hash( bs2_64 ) );
+    assert( Bitset2::stable_hash( bs1_64, 7 )
+            == Bitset2::stable_hash( bs4_64, 7 ) );
+    assert( Bitset2::seeded_hash{ 7 }( bs1_64 )
+            == Bitset2::seeded_hash{ 7 }( bs3_64 ) );
+    assert( Bitset2::seeded_hash{ 7 }( bs1_64 )
+            != Bitset2::seeded_hash{ 8 }( bs1_64 ) );
+    if( sizeof(size_t) == 8 )
+                          assert( Bitset2::stable_hash( bs1_64 ) == hs1_64 );
+#ifdef __SIZEOF_INT128__
+    assert( Bitset2::stable_hash( t1<N,unsigned __int128>( bs1a_64 ) )
+            == Bitset2::stable_hash( bs1_64 ) );
+#endif
   } // for c
 } // test_hash
 
 
+/// Values of stable_hash must never change
+void
+test_stable_hash()
+{
+  std::cout << "Entering test_stable_hash\n";
+
+  constexpr Bitset2::bitset2<64>          bs1( 0x0123456789abcdefull );
+  constexpr Bitset2::bitset2<200,uint8_t> bs2=
+            Bitset2::bitset2<200,uint8_t>( 0x0123456789abcdefull ) << 100;
+  constexpr Bitset2::bitset2<1000>        bs3= ~Bitset2::bitset2<1000>();
+  static_assert( Bitset2::stable_hash( bs1 ) == 0x944a6c798f4065dcull, "" );
+  static_assert( Bitset2::stable_hash( bs2, 42 ) == 0x01535b667e7d0599ull, "" );
+  static_assert( Bitset2::stable_hash( bs3 ) == 0x51a3c1487395bc57ull, "" );
+
+  // Single word: hash differs from value and rotated value
+  Bitset2::bitset2<64> const  bs4( 0xF0ull );
+  Bitset2::bitset2<64> const  bs5( 0xF000ull );
+  auto const h4= std::hash<Bitset2::bitset2<64> >{}( bs4 );
+  auto const h5= std::hash<Bitset2::bitset2<64> >{}( bs5 );
+  assert( h4 != 0xF0ull && h5 != 0xF000ull && h4 != h5 );
+} // test_stable_hash
+
+
 
 int
 main()
@@ -1004,6 +1500,10 @@ main()
   TESTMNY(test_find)
   TESTMNY(test_set_count_size)
   TESTMNY(test_difference)
+  TESTMNY(test_ternary)
+  TESTMNY(test_extract_deposit)
+  TESTMNY(test_range)
+  TESTMNY(test_extract_insert)
   TESTMNY(test_bitwise_ops)
   TESTMNY(test_midpoint)
   TESTMNY(test_add)
@@ -1014,6 +1514,8 @@ main()
   TESTMNY(test_not)
   TESTMNY(test_convert)
   TESTMNY(test_compare)
+  TESTLRG(test_large)
 
   TESTMANY(test_hash)
+  test_stable_hash();
 } // main